@@ -2,25 +2,142 @@
 #define SJTU_ALGORITHM_HPP
 
 #include <functional>
+#include <iterator>
+#include <utility>
 
 namespace sjtu{
 
-template<typename T>
-void sort(T *begin, T *end, std::function<bool(const T&, const T&)> cmp){
-    int len = end - begin;
-    if (len <= 1) return ;
-    T *i = begin, *j = end - 1;
-    T pivot = *(begin + (len + 1) / 2 - 1);
-    while (j - i >= 0){
-        while (cmp(*i, pivot)) i++;
-        while (cmp(pivot, *j)) j--;
-        if (j - i >= 0){
-            std::swap(*i, *j);
-            i++, j--;
+namespace detail{
+
+const int insertion_cutoff = 16;
+
+template<typename RandomIt, typename Compare>
+void insertion_sort(RandomIt begin, RandomIt end, Compare &cmp){
+    if (end - begin <= 1) return ;
+    for (RandomIt i = begin + 1; i != end; ++i){
+        typename std::iterator_traits<RandomIt>::value_type val = std::move(*i);
+        RandomIt j = i;
+        while (j != begin && cmp(val, *(j - 1))){
+            *j = std::move(*(j - 1));
+            --j;
+        }
+        *j = std::move(val);
+    }
+}
+
+template<typename RandomIt, typename Compare>
+void sift_down(RandomIt begin, long root, long len, Compare &cmp){
+    while (true){
+        long child = root * 2 + 1;
+        if (child >= len) return ;
+        if (child + 1 < len && cmp(*(begin + child), *(begin + child + 1))) child++;
+        if (!cmp(*(begin + root), *(begin + child))) return ;
+        std::swap(*(begin + root), *(begin + child));
+        root = child;
+    }
+}
+
+template<typename RandomIt, typename Compare>
+void heap_sort(RandomIt begin, RandomIt end, Compare &cmp){
+    long len = end - begin;
+    for (long i = len / 2 - 1; i >= 0; i--) sift_down(begin, i, len, cmp);
+    for (long i = len - 1; i > 0; i--){
+        std::swap(*begin, *(begin + i));
+        sift_down(begin, 0, i, cmp);
+    }
+}
+
+// Orders *a, *b, *c in place and returns b, the median.
+template<typename RandomIt, typename Compare>
+RandomIt median_of_three(RandomIt a, RandomIt b, RandomIt c, Compare &cmp){
+    if (cmp(*b, *a)) std::swap(*a, *b);
+    if (cmp(*c, *b)){
+        std::swap(*b, *c);
+        if (cmp(*b, *a)) std::swap(*a, *b);
+    }
+    return b;
+}
+
+template<typename RandomIt, typename Compare>
+RandomIt choose_pivot(RandomIt begin, RandomIt end, Compare &cmp){
+    long len = end - begin;
+    RandomIt mid = begin + len / 2;
+    if (len > 128){
+        long s = len / 8;
+        median_of_three(begin, begin + s, begin + 2 * s, cmp);
+        median_of_three(mid - s, mid, mid + s, cmp);
+        median_of_three(end - 1 - 2 * s, end - 1 - s, end - 1, cmp);
+        return median_of_three(begin + s, mid, end - 1 - s, cmp);
+    }
+    return median_of_three(begin, mid, end - 1, cmp);
+}
+
+// Three-way partition: [begin, lt) < pivot, [lt, gt) == pivot, [gt, end) > pivot
+template<typename RandomIt, typename Compare>
+void partition3(RandomIt begin, RandomIt end, RandomIt &lt, RandomIt &gt, Compare &cmp){
+    typename std::iterator_traits<RandomIt>::value_type pivot = *choose_pivot(begin, end, cmp);
+    RandomIt i = begin;
+    lt = begin;
+    gt = end;
+    while (i < gt){
+        if (cmp(*i, pivot)) std::swap(*lt++, *i++);
+        else if (cmp(pivot, *i)) std::swap(*i, *--gt);
+        else i++;
+    }
+}
+
+template<typename RandomIt, typename Compare>
+void introsort_loop(RandomIt begin, RandomIt end, int depth, Compare &cmp){
+    while (end - begin > insertion_cutoff){
+        if (depth == 0){
+            heap_sort(begin, end, cmp);
+            return ;
+        }
+        depth--;
+        RandomIt lt, gt;
+        partition3(begin, end, lt, gt, cmp);
+        // Recurse into the smaller side so the stack stays O(log n).
+        if (lt - begin < end - gt){
+            introsort_loop(begin, lt, depth, cmp);
+            begin = gt;
+        } else {
+            introsort_loop(gt, end, depth, cmp);
+            end = lt;
         }
     }
-    if (j - begin > 0) sort(begin, i, cmp);
-    if (end - i > 1) sort(i, end, cmp);
+}
+
+inline int depth_limit(long len){
+    int depth = 0;
+    for (long n = len; n > 1; n >>= 1) depth += 2;
+    return depth;
+}
+
+template<typename RandomIt, typename Compare>
+void introsort(RandomIt begin, RandomIt end, Compare &cmp){
+    long len = end - begin;
+    if (len <= 1) return ;
+    introsort_loop(begin, end, depth_limit(len), cmp);
+    insertion_sort(begin, end, cmp);
+}
+
+}
+
+template<typename RandomIt, typename Compare>
+void sort(RandomIt begin, RandomIt end, Compare cmp){
+    detail::introsort(begin, end, cmp);
+}
+
+template<typename RandomIt>
+void sort(RandomIt begin, RandomIt end){
+    std::less<> cmp;
+    detail::introsort(begin, end, cmp);
+}
+
+// Kept for callers that name T explicitly, e.g. sjtu::sort<int>(a, a + n, cmp).
+template<typename T>
+void sort(T *begin, T *end, std::function<bool(const T&, const T&)> cmp){
+    detail::introsort(begin, end, cmp);
 }
 
 template<class T>
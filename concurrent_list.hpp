@@ -0,0 +1,195 @@
+#ifndef SJTU_CONCURRENT_LIST_HPP
+#define SJTU_CONCURRENT_LIST_HPP
+
+#include "epoch.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace sjtu {
+
+/*
+ * Lock-free sorted set after Harris and Michael. Every element sits in a
+ * singly linked chain ordered by Compare. erase() first marks the victim
+ * by setting the low bit of its next link, which freezes it in place, and
+ * only then unlinks it; any traversal that runs into a marked node helps to
+ * unlink it. Unlinked nodes are freed through an epoch_domain, so readers
+ * never touch freed memory.
+ *
+ * insert, erase, find and for_each may be called from any number of threads
+ * at once. Construction, destruction and moves of the container itself are
+ * not thread-safe.
+ */
+template<typename T, typename Compare = std::less<>>
+class concurrent_list {
+private:
+    class node_base {
+    public:
+        std::atomic<uintptr_t> next;
+
+        node_base() : next(0) {}
+    };
+
+    class node : public node_base {
+    public:
+        T value;
+
+        template<typename... Args>
+        explicit node(Args &&... args) : value(std::forward<Args>(args)...) {}
+    };
+
+    static node *ptr_of(uintptr_t link) {
+        return reinterpret_cast<node *>(link & ~(uintptr_t)1);
+    }
+
+    static bool marked(uintptr_t link) {
+        return (link & 1) != 0;
+    }
+
+    static uintptr_t link_of(node *p) {
+        return reinterpret_cast<uintptr_t>(p);
+    }
+
+    mutable node_base head;
+    mutable epoch_domain domain;
+    std::atomic<size_t> count;
+    Compare cmp;
+
+    // Finds the first node not less than value and its predecessor, unlinking
+    // (and retiring) marked nodes along the way. Returns whether cur holds an
+    // element equal to value.
+    bool search(const T &value, node_base *&prev, node *&cur, epoch_guard &guard) const {
+        while (true) {
+            prev = &head;
+            cur = ptr_of(prev->next.load());
+            bool restart = false;
+            while (cur != nullptr) {
+                uintptr_t next = cur->next.load();
+                if (marked(next)) {
+                    uintptr_t expected = link_of(cur);
+                    if (!prev->next.compare_exchange_strong(expected, next & ~(uintptr_t)1)) {
+                        restart = true;
+                        break;
+                    }
+                    guard.retire(cur);
+                    cur = ptr_of(next);
+                    continue;
+                }
+                if (!cmp(cur->value, value)) {
+                    return !cmp(value, cur->value);
+                }
+                prev = cur;
+                cur = ptr_of(next);
+            }
+            if (!restart) return false;
+        }
+    }
+
+public:
+    concurrent_list() : count(0), cmp() {}
+
+    explicit concurrent_list(const Compare &c) : count(0), cmp(c) {}
+
+    concurrent_list(const concurrent_list &) = delete;
+    concurrent_list &operator=(const concurrent_list &) = delete;
+
+    ~concurrent_list() {
+        node *cur = ptr_of(head.next.load());
+        while (cur != nullptr) {
+            node *next = ptr_of(cur->next.load());
+            delete cur;
+            cur = next;
+        }
+    }
+
+    // Adds value unless an equal element is already present.
+    bool insert(const T &value) {
+        epoch_guard guard(domain);
+        node *fresh = nullptr;
+        node_base *prev;
+        node *cur;
+        while (true) {
+            if (search(value, prev, cur, guard)) {
+                delete fresh;
+                return false;
+            }
+            if (fresh == nullptr) {
+                fresh = new node(value);
+            }
+            fresh->next.store(link_of(cur), std::memory_order_relaxed);
+            uintptr_t expected = link_of(cur);
+            if (prev->next.compare_exchange_strong(expected, link_of(fresh))) {
+                count.fetch_add(1);
+                return true;
+            }
+        }
+    }
+
+    // Removes the element equal to value; false if there was none. The call
+    // that marks the node is the one that reports success.
+    bool erase(const T &value) {
+        epoch_guard guard(domain);
+        node_base *prev;
+        node *cur;
+        while (true) {
+            if (!search(value, prev, cur, guard)) {
+                return false;
+            }
+            uintptr_t next = cur->next.load();
+            if (marked(next) || !cur->next.compare_exchange_strong(next, next | 1)) {
+                continue;
+            }
+            count.fetch_sub(1);
+            uintptr_t expected = link_of(cur);
+            if (prev->next.compare_exchange_strong(expected, next)) {
+                guard.retire(cur);
+            } else {
+                search(value, prev, cur, guard);
+            }
+            return true;
+        }
+    }
+
+    bool find(const T &value) const {
+        epoch_guard guard(domain);
+        node_base *prev;
+        node *cur;
+        return search(value, prev, cur, guard);
+    }
+
+    // Calls fn on every element present throughout the walk, in order.
+    // Elements inserted or erased concurrently may or may not be seen.
+    template<typename Function>
+    void for_each(Function fn) const {
+        epoch_guard guard(domain);
+        for (node *cur = ptr_of(head.next.load()); cur != nullptr;) {
+            uintptr_t next = cur->next.load();
+            if (!marked(next)) {
+                fn(static_cast<const T &>(cur->value));
+            }
+            cur = ptr_of(next);
+        }
+    }
+
+    // Exact when no update is in flight.
+    size_t size() const {
+        return count.load();
+    }
+
+    bool empty() const {
+        return count.load() == 0;
+    }
+
+    // Frees retired nodes that no reader can reach any more. Useful at a
+    // quiescent point; otherwise reclamation happens as erase() goes along.
+    void collect() {
+        domain.synchronize();
+    }
+};
+
+}
+
+#endif //SJTU_CONCURRENT_LIST_HPP
@@ -0,0 +1,278 @@
+#include "class-integer.hpp"
+#include "class-bint.hpp"
+#include "index_list.hpp"
+
+#include <iostream>
+#include <list>
+#include <string>
+
+const int N = 5e4;
+
+template<typename T>
+bool equal(const std::list<T> &x, const sjtu::index_list<T> &y) {
+    if (x.size() != y.size())
+        return false;
+
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename sjtu::index_list<T>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend() && ity != y.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+    if (itx != x.cend() || ity != y.cend())
+        return false;
+
+    typename std::list<T>::const_reverse_iterator rx = x.crbegin();
+    ity = y.cend();
+    for (; rx != x.crend(); ++rx)
+        if (!(*rx == *--ity))
+            return false;
+
+    return true;
+}
+
+bool testPushPop() {
+    std::list<int> ans;
+    sjtu::index_list<int> myList;
+    for (int i = 0; i < N; ++i) {
+        if (rand() % 2) {
+            ans.push_back(i);
+            myList.push_back(i);
+        } else {
+            ans.push_front(i);
+            myList.push_front(i);
+        }
+    }
+    if (!equal(ans, myList))
+        return false;
+    for (int i = 0; i < N / 2; ++i) {
+        if (rand() % 2) {
+            ans.pop_back();
+            myList.pop_back();
+        } else {
+            ans.pop_front();
+            myList.pop_front();
+        }
+        if (ans.front() != myList.front() || ans.back() != myList.back())
+            return false;
+    }
+    return equal(ans, myList);
+}
+
+bool testInsertErase() {
+    std::list<int> ans;
+    sjtu::index_list<int> myList;
+    for (int i = 0; i < N / 10; ++i) {
+        int pos = ans.empty() ? 0 : rand() % (ans.size() + 1);
+        auto ansIt = ans.begin();
+        auto myIt = myList.begin();
+        for (int j = 0; j < pos; ++j) ++ansIt, ++myIt;
+        if (ans.empty() || rand() % 3) {
+            ansIt = ans.insert(ansIt, i);
+            myIt = myList.insert(myIt, i);
+        } else {
+            if (ansIt == ans.end()) --ansIt, --myIt;
+            ansIt = ans.erase(ansIt);
+            myIt = myList.erase(myIt);
+        }
+        if ((ansIt == ans.end()) != (myIt == myList.end()))
+            return false;
+        if (ansIt != ans.end() && *ansIt != *myIt)
+            return false;
+    }
+    return equal(ans, myList);
+}
+
+bool testCopyAssign() {
+    std::list<Integer> ans;
+    sjtu::index_list<Integer> myList;
+    for (int i = 0; i < N; ++i) {
+        ans.push_back(Integer(i));
+        myList.push_back(Integer(i));
+    }
+    sjtu::index_list<Integer> other(myList);
+    sjtu::index_list<Integer> third;
+    third = other;
+    third = third;
+    sjtu::index_list<Integer> moved(std::move(other));
+    return equal(ans, myList) && equal(ans, third) && equal(ans, moved) && other.empty();
+}
+
+bool testSortMergeUnique() {
+    std::list<int> ans1, ans2;
+    sjtu::index_list<int> myList1, myList2;
+    for (int i = 0; i < N; ++i) {
+        int x = rand() % 1000;
+        ans1.push_back(x);
+        myList1.push_back(x);
+        x = rand() % 1000;
+        ans2.push_front(x);
+        myList2.push_front(x);
+    }
+    ans1.sort(), myList1.sort();
+    ans2.sort(), myList2.sort();
+    if (!equal(ans1, myList1) || !equal(ans2, myList2))
+        return false;
+    ans1.merge(ans2), myList1.merge(myList2);
+    if (!equal(ans1, myList1) || !myList2.empty())
+        return false;
+    ans1.unique(), myList1.unique();
+    if (!equal(ans1, myList1))
+        return false;
+    ans1.sort([](int a, int b) { return a > b; });
+    myList1.sort([](int a, int b) { return a > b; });
+    return equal(ans1, myList1);
+}
+
+bool testReverse() {
+    std::list<Util::Bint> ans;
+    sjtu::index_list<Util::Bint> myList;
+    for (int i = 0; i < N / 30; ++i) {
+        ans.push_back(Util::Bint(i) * Util::Bint(rand()));
+        myList.push_back(ans.back());
+        if (rand() % 50 == 0) {
+            ans.reverse();
+            myList.reverse();
+        }
+    }
+    return equal(ans, myList);
+}
+
+bool testException() {
+    sjtu::index_list<int> myList, otherList;
+    int ans = 0;
+
+    try{ myList.pop_back(); } catch (...) { ans++; }
+    try{ myList.pop_front(); } catch (...) { ans++; }
+    try{ myList.front(); } catch (...) { ans++; }
+    try{ myList.back(); } catch (...) { ans++; }
+    sjtu::index_list<int>::iterator it = myList.end(), oit = otherList.end();
+    try{ *it; } catch (...) { ans++; }
+    try{ it--; } catch (...) { ans++; }
+    try{ it++; } catch (...) { ans++; }
+    try{ myList.erase(it); } catch (...) { ans++; }
+    try{ myList.insert(oit, 0); } catch (...) { ans++; }
+
+    return ans == 9;
+}
+
+bool testStaleIterator() {
+    sjtu::index_list<int> myList;
+    for (int i = 0; i < 100; ++i)
+        myList.push_back(i);
+
+    sjtu::index_list<int>::iterator it = myList.begin(), keep = myList.begin();
+    ++it, ++it;
+    ++keep;
+    myList.erase(it);
+    myList.push_back(1000);
+    for (int i = 0; i < N; ++i)
+        myList.push_front(i);
+
+    int ans = 0;
+    try{ *it; } catch (...) { ans++; }
+    try{ ++it; } catch (...) { ans++; }
+    try{ myList.erase(it); } catch (...) { ans++; }
+    return ans == 3 && *keep == 1 && myList.back() == 1000;
+}
+
+bool testSelfReference() {
+    // Arguments that refer into the list must survive the growth they cause.
+    std::list<std::string> ans;
+    sjtu::index_list<std::string> myList;
+    ans.push_back("seed-value-long-enough-to-allocate");
+    myList.push_back("seed-value-long-enough-to-allocate");
+    for (int i = 0; i < 1000; ++i) {
+        switch (i % 4) {
+            case 0:
+                ans.push_back(ans.front());
+                myList.push_back(myList.front());
+                break;
+            case 1:
+                ans.push_front(ans.back());
+                myList.push_front(myList.back());
+                break;
+            case 2:
+                ans.insert(ans.begin(), *ans.begin());
+                myList.insert(myList.begin(), *myList.begin());
+                break;
+            default:
+                ans.emplace_back(ans.back());
+                myList.emplace_back(myList.back());
+        }
+    }
+    return equal(ans, myList);
+}
+
+bool testSortThrow() {
+    // Fail at different depths: inside a run scan, a bin merge and the
+    // final combine. The list must stay whole after each failure.
+    std::list<std::string> ans;
+    sjtu::index_list<std::string> myList;
+    for (int i = 0; i < N / 10; ++i) {
+        std::string s = std::to_string(rand() % 1000) + std::string(30, 'x');
+        ans.push_back(s);
+        myList.push_back(s);
+    }
+    std::list<std::string> sorted(ans);
+    sorted.sort();
+    for (int budget : {0, 1, 7, 100, 5000, 20000}) {
+        // Each budget fails on a fresh copy, so the later ones still throw.
+        sjtu::index_list<std::string> copy(myList);
+        int left = budget;
+        bool thrown = false;
+        try {
+            copy.sort([&left](const std::string &a, const std::string &b) {
+                if (left-- == 0) throw 0;
+                return a < b;
+            });
+        } catch (int) {
+            thrown = true;
+        }
+        if (!thrown || copy.size() != ans.size())
+            return false;
+        size_t n = 0;
+        for (auto it = copy.begin(); it != copy.end(); ++it) n++;
+        for (auto it = copy.end(); it != copy.begin(); --it) n--;
+        if (n != 0)
+            return false;
+        copy.sort();
+        if (!equal(sorted, copy))
+            return false;
+    }
+    return equal(ans, myList);
+}
+
+int main(){
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testPushPop, testInsertErase, testCopyAssign, testSortMergeUnique, testReverse, testException,
+            testStaleIterator, testSelfReference, testSortThrow
+    };
+    const char* Messages[] = {
+            "Test 1: Testing push & pop...",
+            "Test 2: Testing insert() & erase()...",
+            "Test 3: Testing copy, assignment & move...",
+            "Test 4: Testing sort(), merge() & unique()...",
+            "Test 5: Testing reverse()...",
+            "Test 6: Testing exception throw...",
+            "Test 7: Testing stale iterator detection...",
+            "Test 8: Testing arguments that refer into the list...",
+            "Test 9: Testing sort() with a throwing comparator..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,210 @@
+// sjtu::list over the allocators in memory.hpp.
+
+#include "list.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <list>
+#include <type_traits>
+
+const int N = 2e4;
+
+int live = 0;
+class Counted {
+public:
+    int value;
+    Counted(int v) : value(v) { live++; }
+    Counted(const Counted &other) : value(other.value) { live++; }
+    Counted &operator=(const Counted &other) { value = other.value; return *this; }
+    ~Counted() { live--; }
+    bool operator==(const Counted &rhs) const { return value == rhs.value; }
+    bool operator<(const Counted &rhs) const { return value < rhs.value; }
+};
+
+typedef sjtu::list<Counted, sjtu::arena_allocator<Counted>> ArenaList;
+typedef sjtu::list<Counted, sjtu::pool_allocator<Counted>> PoolList;
+
+// Both allocators make shared state when default constructed.
+static_assert(!std::is_nothrow_default_constructible<ArenaList>::value, "");
+static_assert(!std::is_nothrow_default_constructible<PoolList>::value, "");
+static_assert(std::is_nothrow_default_constructible<sjtu::list<Counted>>::value, "");
+
+template<typename List>
+bool equal(const std::list<int> &x, const List &y) {
+    if (x.size() != y.size())
+        return false;
+    std::list<int>::const_iterator itx = x.cbegin();
+    typename List::const_iterator ity = y.cbegin();
+    for (; itx != x.cend(); ++itx, ++ity)
+        if (*itx != ity->value)
+            return false;
+    return true;
+}
+
+template<typename List>
+bool testPushErase() {
+    int before = live;
+    {
+        std::list<int> ans;
+        List myList;
+        for (int i = 0; i < N; ++i) {
+            int x = rand();
+            if (rand() % 2) ans.push_back(x), myList.push_back(Counted(x));
+            else ans.push_front(x), myList.push_front(Counted(x));
+        }
+        std::list<int>::iterator ansIt = ans.begin();
+        typename List::iterator myIt = myList.begin();
+        while (ansIt != ans.end()) {
+            if (rand() % 3 == 0) {
+                ansIt = ans.erase(ansIt);
+                myIt = myList.erase(myIt);
+            } else {
+                ++ansIt, ++myIt;
+            }
+        }
+        if (!equal(ans, myList) || live != before + (int)ans.size())
+            return false;
+    }
+    return live == before;
+}
+
+template<typename List>
+bool testCopy() {
+    std::list<int> ans1, ans2;
+    List myList1;
+    for (int i = 0; i < N; ++i) {
+        int x = rand() % N;
+        ans1.push_back(x);
+        myList1.push_back(Counted(x));
+    }
+
+    // select_on_container_copy_construction hands the copy the same
+    // allocator, so the two lists may exchange nodes.
+    List myList2(myList1);
+    ans2 = ans1;
+    if (!(myList2.get_allocator() == myList1.get_allocator()) || !equal(ans2, myList2))
+        return false;
+    myList2.push_back(Counted(-1)), ans2.push_back(-1);
+    ans1.sort(), myList1.sort();
+    ans2.sort(), myList2.sort();
+    ans1.merge(ans2), myList1.merge(myList2);
+    if (!myList2.empty() || !equal(ans1, myList1))
+        return false;
+
+    List myList3(myList1);
+    myList3.splice(myList3.begin(), myList1);
+    ans2 = ans1;
+    ans1.splice(ans1.begin(), ans2);
+    return myList1.empty() && equal(ans1, myList3);
+}
+
+template<typename List>
+bool testMoveSwap() {
+    std::list<int> ans1, ans2;
+    List myList1, myList2;
+    for (int i = 0; i < N; ++i) {
+        ans1.push_back(i), myList1.push_back(Counted(i));
+        ans2.push_front(i), myList2.push_front(Counted(i));
+    }
+    auto alloc1 = myList1.get_allocator();
+    auto alloc2 = myList2.get_allocator();
+    if (alloc1 == alloc2)
+        return false;
+
+    // Allocators travel with their nodes.
+    myList1.swap(myList2), ans1.swap(ans2);
+    if (!(myList1.get_allocator() == alloc2) || !(myList2.get_allocator() == alloc1))
+        return false;
+    List myList3(std::move(myList1));
+    if (!myList1.empty() || !(myList3.get_allocator() == alloc2) || !equal(ans1, myList3))
+        return false;
+    myList2 = std::move(myList3);
+    if (!(myList2.get_allocator() == alloc2) || !equal(ans1, myList2))
+        return false;
+
+    // Lists with different allocators cannot exchange nodes.
+    List other;
+    other.push_back(Counted(0));
+    int thrown = 0;
+    try { myList2.merge(other); } catch (sjtu::runtime_error &) { thrown++; }
+    try { myList2.splice(myList2.end(), other); } catch (sjtu::runtime_error &) { thrown++; }
+    return thrown == 2 && other.size() == 1 && equal(ans1, myList2);
+}
+
+bool testArenaRelease() {
+    int before = live;
+    sjtu::arena_allocator<Counted> alloc;
+    {
+        ArenaList myList(alloc);
+        for (int i = 0; i < N; ++i)
+            myList.push_back(Counted(i));
+        if (!(myList.get_allocator() == alloc))
+            return false;
+    }
+    if (live != before)
+        return false;
+
+    // Every list on the arena is gone, so its chunks can be dropped and the
+    // arena used again.
+    alloc.arena_release();
+    std::list<int> ans;
+    ArenaList myList(alloc);
+    for (int i = 0; i < N; ++i)
+        ans.push_front(i), myList.push_front(Counted(i));
+    return equal(ans, myList);
+}
+
+bool testPoolShrink() {
+    sjtu::pool_allocator<Counted> alloc(64);
+    PoolList myList(alloc);
+    for (int i = 0; i < N; ++i)
+        myList.push_back(Counted(i));
+    if (alloc.shrink() != 0)
+        return false;
+
+    // Nodes go back to the shared pool; shrink() frees the idle slabs.
+    PoolList copy(myList);
+    myList.clear();
+    size_t freed = alloc.shrink(1);
+    if (freed == 0 || alloc.shrink(1) != 0 || alloc.shrink() != 1)
+        return false;
+    for (int i = 0; i < N; ++i)
+        myList.push_back(Counted(-i));
+    copy.clear(), myList.clear();
+    return myList.get_allocator().shrink() > freed;
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testPushErase<ArenaList>, testPushErase<PoolList>, testCopy<ArenaList>, testCopy<PoolList>,
+            testMoveSwap<ArenaList>, testMoveSwap<PoolList>, testArenaRelease, testPoolShrink
+    };
+    const char *Messages[] = {
+            "Test 1: Testing push & erase with arena_allocator...",
+            "Test 2: Testing push & erase with pool_allocator...",
+            "Test 3: Testing copies, merge() & splice() with arena_allocator...",
+            "Test 4: Testing copies, merge() & splice() with pool_allocator...",
+            "Test 5: Testing move & swap with arena_allocator...",
+            "Test 6: Testing move & swap with pool_allocator...",
+            "Test 7: Testing arena_release()...",
+            "Test 8: Testing pool_allocator shrink()..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay && live == 0)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "rcu_list.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <list>
+#include <thread>
+#include <vector>
+
+const int Readers = 6;
+const int N = 2e4;
+
+struct Tracked {
+    static std::atomic<long> live;
+    int key;
+
+    Tracked(int k) : key(k) { live++; }
+    Tracked(const Tracked &other) : key(other.key) { live++; }
+    ~Tracked() { live--; }
+
+    bool operator==(const Tracked &rhs) const { return key == rhs.key; }
+};
+
+std::atomic<long> Tracked::live(0);
+
+bool equal(const std::list<int> &x, const sjtu::rcu_list<int> &y) {
+    if (x.size() != y.size())
+        return false;
+    auto v = y.read();
+    auto itx = x.begin();
+    auto ity = v.begin();
+    for (; itx != x.end() && ity != v.end(); ++itx, ++ity)
+        if (*itx != *ity)
+            return false;
+    return itx == x.end() && ity == v.end();
+}
+
+bool testSingleThread() {
+    std::list<int> ans;
+    sjtu::rcu_list<int> myList;
+    for (int i = 0; i < N / 10; ++i) {
+        int key = rand() % 100;
+        switch (rand() % 4) {
+            case 0:
+                ans.push_back(key);
+                myList.push_back(key);
+                break;
+            case 1:
+                ans.push_front(key);
+                myList.push_front(key);
+                break;
+            case 2: {
+                auto it = ans.begin();
+                while (it != ans.end() && *it <= key) ++it;
+                ans.insert(it, key);
+                myList.insert_before_if(key, [key](int v) { return v > key; });
+                break;
+            }
+            default: {
+                size_t before = ans.size();
+                ans.remove(key);
+                if (myList.remove(key) != before - ans.size())
+                    return false;
+            }
+        }
+    }
+    if (!equal(ans, myList))
+        return false;
+    std::vector<int> fresh{3, 1, 4, 1, 5};
+    myList.assign(fresh.begin(), fresh.end());
+    ans.assign(fresh.begin(), fresh.end());
+    if (!equal(ans, myList))
+        return false;
+    myList.clear();
+    myList.push_back(9);
+    ans.clear();
+    ans.push_back(9);
+    return equal(ans, myList);
+}
+
+bool testViewSurvivesWriters() {
+    sjtu::rcu_list<int> myList;
+    for (int i = 0; i < 100; ++i)
+        myList.push_back(i);
+    auto v = myList.read();
+    auto it = v.begin();
+    for (int i = 0; i < 10; ++i) ++it;
+    // Everything is unlinked under the open view, which can still finish.
+    myList.clear();
+    myList.collect();
+    int expect = 10;
+    for (; it != v.end(); ++it)
+        if (*it != expect++)
+            return false;
+    return expect == 100 && myList.empty();
+}
+
+bool testConcurrentReaders() {
+    sjtu::rcu_list<int> myList;
+    std::atomic<bool> stop(false), ok(true);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < Readers; ++r) {
+        readers.emplace_back([&] {
+            // The writer keeps the list strictly increasing, so every walk
+            // must be too, whatever it overlaps with.
+            while (!stop) {
+                int last = -1;
+                myList.for_each([&](int v) {
+                    if (v <= last) ok = false;
+                    last = v;
+                });
+            }
+        });
+    }
+    for (int i = 0; i < N; ++i) {
+        int key = rand() % 500;
+        if (rand() % 2)
+            myList.remove(key);
+        else if (myList.remove(key) == 0)
+            myList.insert_before_if(key, [key](int v) { return v > key; });
+    }
+    std::vector<int> fresh;
+    for (int i = 0; i < 1000; i += 3) fresh.push_back(i);
+    myList.assign(fresh.begin(), fresh.end());
+    stop = true;
+    for (auto &t : readers)
+        t.join();
+    std::list<int> ans(fresh.begin(), fresh.end());
+    return ok && equal(ans, myList);
+}
+
+bool testReclamation() {
+    {
+        sjtu::rcu_list<Tracked> myList;
+        std::atomic<bool> stop(false);
+        std::thread reader([&] {
+            while (!stop)
+                myList.for_each([](const Tracked &) {});
+        });
+        for (int i = 0; i < N; ++i) {
+            myList.push_back(Tracked(i));
+            if (i % 3 == 0)
+                myList.remove(Tracked(i / 3));
+        }
+        stop = true;
+        reader.join();
+        myList.collect();
+        if (Tracked::live != (long)myList.size())
+            return false;
+    }
+    return Tracked::live == 0;
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testSingleThread, testViewSurvivesWriters, testConcurrentReaders, testReclamation
+    };
+    const char *Messages[] = {
+            "Test 1: Testing writers on one thread...",
+            "Test 2: Testing a view outliving erased nodes...",
+            "Test 3: Testing concurrent readers...",
+            "Test 4: Testing memory reclamation..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include "list.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <list>
+
+const int N = 1e5;
+
+template<typename T>
+bool equal(const std::list<T> &x, const sjtu::list<T> &y) {
+    if (x.size() != y.size())
+        return false;
+    if (!x.empty() && (x.front() != y.front() || x.back() != y.back()))
+        return false;
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename sjtu::list<T>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+    if (ity != y.cend())
+        return false;
+    typename std::list<T>::const_reverse_iterator rx = x.crbegin();
+    for (; rx != x.crend(); ++rx)
+        if (!(*rx == *--ity))
+            return false;
+    return true;
+}
+
+bool testPushPop() {
+    std::list<int> ans;
+    sjtu::list<int> myList;
+    for (int i = 0; i < N; ++i) {
+        switch (rand() % 6) {
+            case 0:
+                ans.push_back(i);
+                myList.push_back(i);
+                break;
+            case 1:
+                ans.push_front(i);
+                myList.push_front(i);
+                break;
+            case 2:
+                if (!ans.empty()) {
+                    ans.pop_back();
+                    myList.pop_back();
+                }
+                break;
+            case 3:
+                if (!ans.empty()) {
+                    ans.pop_front();
+                    myList.pop_front();
+                }
+                break;
+            default:
+                ans.reverse();
+                myList.reverse();
+        }
+        if (!ans.empty() && (ans.front() != myList.front() || ans.back() != myList.back()))
+            return false;
+    }
+    return equal(ans, myList);
+}
+
+bool testInsertErase() {
+    std::list<int> ans;
+    sjtu::list<int> myList;
+    for (int i = 0; i < N / 10; ++i) {
+        ans.push_back(i);
+        myList.push_back(i);
+    }
+    std::list<int>::iterator itx = ans.begin();
+    sjtu::list<int>::iterator ity = myList.begin();
+    for (int i = 0; i < N; ++i) {
+        if (rand() % 10 == 0) {
+            // Iterators stay on their element and follow the new direction.
+            ans.reverse();
+            myList.reverse();
+        }
+        if (itx == ans.end()) {
+            itx = ans.begin();
+            ity = myList.begin();
+        }
+        if (rand() % 2) {
+            itx = ans.insert(itx, i);
+            ity = myList.insert(ity, i);
+            ++itx;
+            ++ity;
+        } else if (itx != ans.end()) {
+            itx = ans.erase(itx);
+            ity = myList.erase(ity);
+        }
+        if ((itx == ans.end()) != (ity == myList.end()) || (itx != ans.end() && *itx != *ity))
+            return false;
+    }
+    return equal(ans, myList);
+}
+
+bool testSplice() {
+    std::list<int> ans1, ans2;
+    sjtu::list<int> myList1, myList2;
+    for (int i = 0; i < N / 10; ++i) {
+        int x = rand();
+        if (rand() % 2) {
+            ans1.push_back(x);
+            myList1.push_back(x);
+        } else {
+            ans2.push_back(x);
+            myList2.push_back(x);
+        }
+        switch (rand() % 8) {
+            case 0:
+                ans1.reverse();
+                myList1.reverse();
+                break;
+            case 1:
+                ans2.reverse();
+                myList2.reverse();
+                break;
+            case 2:
+                if (ans2.size() > 2) {
+                    // Moves a middle run of list 2 to the front of list 1.
+                    std::list<int>::iterator fx = ans2.begin(), lx = ans2.end();
+                    sjtu::list<int>::iterator fy = myList2.begin(), ly = myList2.end();
+                    ++fx, ++fy, --lx, --ly;
+                    ans1.splice(ans1.begin(), ans2, fx, lx);
+                    myList1.splice(myList1.begin(), myList2, fy, ly);
+                }
+                break;
+            case 3:
+                if (rand() % 10 == 0) {
+                    ans1.splice(ans1.end(), ans2);
+                    myList1.splice(myList1.end(), myList2);
+                }
+                break;
+        }
+    }
+    return equal(ans1, myList1) && equal(ans2, myList2);
+}
+
+bool testSortMerge() {
+    std::list<int> ans1, ans2;
+    sjtu::list<int> myList1, myList2;
+    for (int i = 0; i < N / 2; ++i) {
+        int x = rand() % N;
+        ans1.push_back(x);
+        myList1.push_back(x);
+        ans2.push_front(x / 2);
+        myList2.push_front(x / 2);
+    }
+    ans1.reverse();
+    myList1.reverse();
+    ans1.unique();
+    myList1.unique();
+    if (!equal(ans1, myList1))
+        return false;
+    ans1.sort();
+    myList1.sort();
+    ans2.sort();
+    myList2.sort();
+    ans2.reverse();
+    myList2.reverse();
+    ans2.reverse();
+    myList2.reverse();
+    ans1.merge(ans2);
+    myList1.merge(myList2);
+    if (!myList2.empty() || !equal(ans1, myList1))
+        return false;
+    ans1.reverse();
+    myList1.reverse();
+    myList1.normalize();
+    sjtu::list<int> copy = myList1;
+    return equal(ans1, myList1) && equal(ans1, copy);
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testPushPop, testInsertErase, testSplice, testSortMerge
+    };
+    const char *Messages[] = {
+            "Test 1: Testing push & pop across reverse()...",
+            "Test 2: Testing insert() & erase() across reverse()...",
+            "Test 3: Testing splice() between reversed lists...",
+            "Test 4: Testing sort(), merge() & normalize() after reverse()..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
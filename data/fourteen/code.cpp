@@ -0,0 +1,163 @@
+#include "list.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <list>
+#include <utility>
+#include <vector>
+
+const int N = 1e5;
+
+typedef std::pair<int, int> Tagged;
+
+struct ByKey {
+    long long *calls;
+
+    bool operator()(const Tagged &a, const Tagged &b) const {
+        ++*calls;
+        return a.first < b.first;
+    }
+};
+
+template<typename T>
+bool equal(const std::list<T> &x, const sjtu::list<T> &y) {
+    if (x.size() != y.size())
+        return false;
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename sjtu::list<T>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+    return ity == y.cend();
+}
+
+bool testMergeStable() {
+    long long calls = 0;
+    ByKey cmp = {&calls};
+    for (int round = 0; round < 20; ++round) {
+        std::list<Tagged> ans1, ans2;
+        sjtu::list<Tagged> myList1, myList2;
+        int n1 = rand() % (N / 20), n2 = rand() % (N / 20);
+        for (int i = 0; i < n1; ++i) ans1.push_back(Tagged(rand() % 100, i));
+        for (int i = 0; i < n2; ++i) ans2.push_back(Tagged(rand() % 100, -i));
+        ans1.sort(cmp);
+        ans2.sort(cmp);
+        for (const Tagged &t : ans1) myList1.push_back(t);
+        for (const Tagged &t : ans2) myList2.push_back(t);
+        ans1.merge(ans2, cmp);
+        myList1.merge(myList2, cmp);
+        if (!myList2.empty() || !equal(ans1, myList1))
+            return false;
+    }
+    return true;
+}
+
+bool testMergeRuns() {
+    // Alternating blocks of 1000: the merge should cost about one gallop per
+    // block, not one comparison per element.
+    long long calls = 0;
+    ByKey cmp = {&calls};
+    sjtu::list<Tagged> myList1, myList2;
+    std::list<Tagged> ans;
+    for (int i = 0; i < N; ++i) {
+        Tagged t(i, 0);
+        ans.push_back(t);
+        if (i / 1000 % 2) myList2.push_back(t);
+        else myList1.push_back(t);
+    }
+    myList1.merge(myList2, cmp);
+    return myList2.empty() && calls < N / 10 && equal(ans, myList1);
+}
+
+bool testMergeInterleaved() {
+    sjtu::list<int> myList1, myList2;
+    std::list<int> ans;
+    for (int i = 0; i < N; ++i) {
+        ans.push_back(i);
+        if (i % 2) myList2.push_back(i);
+        else myList1.push_back(i);
+    }
+    myList2.merge(myList1);
+    myList2.push_back(N);
+    ans.push_back(N);
+    return myList1.empty() && myList2.size() == (size_t)N + 1 && equal(ans, myList2);
+}
+
+bool testMergeAll() {
+    long long calls = 0;
+    ByKey cmp = {&calls};
+    for (int round = 0; round < 10; ++round) {
+        int k = 1 + rand() % 300;
+        std::vector<sjtu::list<Tagged>> shards(k);
+        sjtu::list<Tagged> myList;
+        std::list<Tagged> ans;
+        for (int i = 0; i < N / 10; ++i) {
+            int s = rand() % (k + 1);
+            Tagged t(rand() % 1000, i);
+            // Equal keys come out in input order: this list, then the shards.
+            if (s == k) myList.push_back(t);
+            else shards[s].push_back(t);
+        }
+        myList.sort(cmp);
+        for (const Tagged &t : myList) ans.push_back(t);
+        for (int s = 0; s < k; ++s) {
+            shards[s].sort(cmp);
+            std::list<Tagged> part;
+            for (const Tagged &t : shards[s]) part.push_back(t);
+            ans.merge(part, cmp);
+        }
+        myList.merge_all(shards.begin(), shards.end(), cmp);
+        for (int s = 0; s < k; ++s)
+            if (!shards[s].empty())
+                return false;
+        if (!equal(ans, myList))
+            return false;
+    }
+    return true;
+}
+
+bool testMergeAllShards() {
+    const int Shards = 256;
+    std::vector<sjtu::list<int>> shards(Shards);
+    for (int i = 0; i < N; ++i)
+        shards[rand() % Shards].push_back(i);
+    shards.push_back(sjtu::list<int>());
+    sjtu::list<int> myList;
+    myList.merge_all(shards.begin(), shards.end());
+    std::list<int> ans;
+    for (int i = 0; i < N; ++i)
+        ans.push_back(i);
+    return equal(ans, myList);
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testMergeStable, testMergeRuns, testMergeInterleaved, testMergeAll, testMergeAllShards
+    };
+    const char *Messages[] = {
+            "Test 1: Testing merge() stability...",
+            "Test 2: Testing merge() over long runs...",
+            "Test 3: Testing merge() of interleaved lists...",
+            "Test 4: Testing merge_all() stability...",
+            "Test 5: Testing merge_all() over many shards..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Throughput of concurrent_list against list behind one global mutex, for
+// 1 .. N threads. Usage: list_nine_bench [max_threads] [ops_per_thread]
+
+#include "concurrent_list.hpp"
+#include "list.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const int Keys = 1 << 12;
+
+// Sorted sjtu::list guarded by a single mutex, the setup being replaced.
+class locked_list {
+private:
+    std::mutex lock;
+    sjtu::list<int> data;
+
+public:
+    bool insert(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = data.begin();
+        while (it != data.end() && *it < key) ++it;
+        if (it != data.end() && *it == key) return false;
+        data.insert(it, key);
+        return true;
+    }
+
+    bool erase(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = data.begin();
+        while (it != data.end() && *it < key) ++it;
+        if (it == data.end() || *it != key) return false;
+        data.erase(it);
+        return true;
+    }
+
+    bool find(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto it = data.begin(); it != data.end() && *it <= key; ++it)
+            if (*it == key) return true;
+        return false;
+    }
+};
+
+// 80% find, 10% insert, 10% erase over Keys keys, half of them preloaded.
+template<typename Set>
+double run(Set &set, int threads, long ops) {
+    for (int k = 0; k < Keys; k += 2) set.insert(k);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&set, ops, t] {
+            unsigned seed = t * 2654435761u + 1;
+            for (long i = 0; i < ops; ++i) {
+                seed = seed * 1103515245u + 12345u;
+                int key = (seed >> 8) % Keys;
+                unsigned op = (seed >> 4) % 10;
+                if (op == 0) set.insert(key);
+                else if (op == 1) set.erase(key);
+                else set.find(key);
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return threads * ops / seconds / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : (int)std::thread::hardware_concurrency();
+    long ops = argc > 2 ? atol(argv[2]) : 200000;
+    if (maxThreads < 1) maxThreads = 1;
+
+    printf("threads  concurrent_list Mops/s  mutex+list Mops/s\n");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        sjtu::concurrent_list<int> lockFree;
+        locked_list locked;
+        double a = run(lockFree, threads, ops);
+        double b = run(locked, threads, ops);
+        printf("%7d  %22.3f  %17.3f\n", threads, a, b);
+        if (threads < maxThreads && threads * 2 > maxThreads) threads = maxThreads / 2;
+    }
+    return 0;
+}
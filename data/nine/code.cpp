@@ -0,0 +1,191 @@
+#include "concurrent_list.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <set>
+#include <thread>
+#include <vector>
+
+const int Threads = 8;
+const int N = 2e4;
+
+struct Tracked {
+    static std::atomic<long> live;
+    int key;
+
+    Tracked(int k) : key(k) { live++; }
+    Tracked(const Tracked &other) : key(other.key) { live++; }
+    ~Tracked() { live--; }
+
+    bool operator<(const Tracked &rhs) const { return key < rhs.key; }
+};
+
+std::atomic<long> Tracked::live(0);
+
+template<typename Function>
+void runThreads(int n, Function fn) {
+    std::vector<std::thread> workers;
+    for (int i = 0; i < n; ++i)
+        workers.emplace_back(fn, i);
+    for (auto &t : workers)
+        t.join();
+}
+
+template<typename T>
+bool sameAs(const sjtu::concurrent_list<T> &x, const std::set<T> &y) {
+    std::vector<T> seen;
+    x.for_each([&](const T &v) { seen.push_back(v); });
+    if (seen.size() != y.size() || x.size() != y.size())
+        return false;
+    size_t i = 0;
+    for (const T &v : y)
+        if (!(seen[i++] == v))
+            return false;
+    return true;
+}
+
+bool testSingleThread() {
+    sjtu::concurrent_list<int> myList;
+    std::set<int> ans;
+    for (int i = 0; i < N; ++i) {
+        int key = rand() % (N / 4);
+        switch (rand() % 3) {
+            case 0:
+                if (myList.insert(key) != ans.insert(key).second)
+                    return false;
+                break;
+            case 1:
+                if (myList.erase(key) != (ans.erase(key) == 1))
+                    return false;
+                break;
+            default:
+                if (myList.find(key) != (ans.count(key) == 1))
+                    return false;
+        }
+    }
+    return sameAs(myList, ans);
+}
+
+bool testConcurrentInsert() {
+    sjtu::concurrent_list<int> myList;
+    std::atomic<int> duplicates(0);
+    runThreads(Threads, [&](int t) {
+        // Every thread inserts every key; only one insert per key may win.
+        for (int i = 0; i < N / 4; ++i) {
+            int key = (i * 7919 + t * 131) % (N / 4);
+            myList.insert(key);
+        }
+        for (int i = t; i < N; i += Threads)
+            if (!myList.insert(N + i))
+                duplicates++;
+    });
+    std::set<int> ans;
+    for (int i = 0; i < N / 4; ++i) ans.insert(i);
+    for (int i = 0; i < N; ++i) ans.insert(N + i);
+    return duplicates == 0 && sameAs(myList, ans);
+}
+
+bool testConcurrentErase() {
+    sjtu::concurrent_list<int> myList;
+    for (int i = 0; i < N; ++i)
+        myList.insert(i);
+    std::atomic<int> erased(0);
+    runThreads(Threads, [&](int) {
+        for (int i = 0; i < N; ++i)
+            if (myList.erase(i))
+                erased++;
+    });
+    std::set<int> ans;
+    return erased == N && myList.empty() && sameAs(myList, ans);
+}
+
+bool testMixed() {
+    sjtu::concurrent_list<int> myList;
+    std::vector<std::set<int>> owned(Threads);
+    std::atomic<bool> ok(true);
+    std::atomic<int> done(0);
+    runThreads(Threads + 2, [&](int t) {
+        if (t >= Threads) {
+            // Readers: every walk must come out strictly increasing.
+            while (done < Threads) {
+                int last = -1;
+                bool sorted = true;
+                myList.for_each([&](int v) {
+                    if (v <= last) sorted = false;
+                    last = v;
+                });
+                if (!sorted) ok = false;
+                myList.find(last);
+            }
+            return;
+        }
+        // Writers own the keys congruent to t and mirror them in a std::set.
+        unsigned seed = t * 2654435761u + 1;
+        for (int i = 0; i < N; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            int key = (int)((seed >> 8) % (N / Threads)) * Threads + t;
+            if ((seed >> 4) % 2) {
+                if (myList.insert(key) != owned[t].insert(key).second)
+                    ok = false;
+            } else {
+                if (myList.erase(key) != (owned[t].erase(key) == 1))
+                    ok = false;
+            }
+        }
+        done++;
+    });
+    std::set<int> ans;
+    for (auto &s : owned) ans.insert(s.begin(), s.end());
+    return ok && sameAs(myList, ans);
+}
+
+bool testReclamation() {
+    {
+        sjtu::concurrent_list<Tracked> myList;
+        runThreads(Threads, [&](int t) {
+            for (int round = 0; round < 4; ++round) {
+                for (int i = t; i < N / 4; i += Threads)
+                    myList.insert(Tracked(i));
+                for (int i = t; i < N / 4; i += Threads)
+                    if (i % 2 == round % 2)
+                        myList.erase(Tracked(i));
+            }
+        });
+        myList.collect();
+        if (Tracked::live != (long)myList.size())
+            return false;
+    }
+    return Tracked::live == 0;
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testSingleThread, testConcurrentInsert, testConcurrentErase, testMixed, testReclamation
+    };
+    const char *Messages[] = {
+            "Test 1: Testing insert(), erase() & find() on one thread...",
+            "Test 2: Testing concurrent insert()...",
+            "Test 3: Testing concurrent erase()...",
+            "Test 4: Testing mixed writers with concurrent readers...",
+            "Test 5: Testing memory reclamation..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,123 @@
+// sjtu::sort on arrays: introsort against std::sort, a quicksort killer
+// and inputs full of duplicates.
+
+#include "algorithm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+const int N = 1e5;
+
+bool same(std::vector<int> a) {
+    std::vector<int> b = a;
+    std::sort(a.begin(), a.end());
+    sjtu::sort(b.begin(), b.end());
+    return a == b;
+}
+
+bool testPatterns() {
+    std::vector<int> random(N), sorted(N), reversed(N), pipe(N), sawtooth(N);
+    for (int i = 0; i < N; ++i) {
+        random[i] = rand();
+        sorted[i] = i;
+        reversed[i] = N - i;
+        pipe[i] = i < N / 2 ? i : N - i;
+        sawtooth[i] = i % 1000;
+    }
+    if (!same(random) || !same(sorted) || !same(reversed) || !same(pipe) || !same(sawtooth))
+        return false;
+    for (int n = 0; n < 100; ++n) {
+        std::vector<int> small(n);
+        for (int i = 0; i < n; ++i) small[i] = rand() % 10;
+        if (!same(small))
+            return false;
+    }
+
+    // Plain pointers and the std::function overload.
+    std::vector<int> a = random;
+    sjtu::sort<int>(a.data(), a.data() + N, [](const int &x, const int &y) { return x > y; });
+    return std::is_sorted(a.rbegin(), a.rend());
+}
+
+// McIlroy's adversary: values are decided lazily, always so as to make the
+// pivot as bad as possible. It drives any plain quicksort quadratic, so
+// only the heapsort fallback keeps introsort at O(n log n) comparisons.
+struct Adversary {
+    std::vector<int> val;
+    int gas, solid, candidate;
+    long comparisons;
+
+    Adversary(int n) : val(n, n), gas(n), solid(0), candidate(0), comparisons(0) {}
+
+    bool less(int x, int y) {
+        comparisons++;
+        if (val[x] == gas && val[y] == gas) {
+            if (x == candidate) val[x] = solid++;
+            else val[y] = solid++;
+        }
+        if (val[x] == gas) candidate = x;
+        else if (val[y] == gas) candidate = y;
+        return val[x] < val[y];
+    }
+};
+
+bool testAdversary() {
+    Adversary adversary(N);
+    std::vector<int> a(N);
+    for (int i = 0; i < N; ++i) a[i] = i;
+    sjtu::sort(a.begin(), a.end(), [&adversary](int x, int y) { return adversary.less(x, y); });
+    for (int i = 1; i < N; ++i)
+        if (adversary.val[a[i]] < adversary.val[a[i - 1]])
+            return false;
+    return adversary.comparisons < 8 * N * std::log2(N);
+}
+
+bool testDuplicates() {
+    for (int keys = 1; keys <= 1000; keys *= 10) {
+        std::vector<int> a(N);
+        for (int i = 0; i < N; ++i) a[i] = rand() % keys;
+        if (!same(a))
+            return false;
+    }
+
+    // Three-way partitioning settles a run of equal keys in one pass.
+    long comparisons = 0;
+    std::vector<int> equal(N, 7);
+    sjtu::sort(equal.begin(), equal.end(), [&comparisons](int x, int y) {
+        comparisons++;
+        return x < y;
+    });
+    return comparisons < 4L * N;
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testPatterns, testAdversary, testDuplicates
+    };
+    const char *Messages[] = {
+            "Test 1: Testing sort() on common input patterns...",
+            "Test 2: Testing sort() against a quicksort adversary...",
+            "Test 3: Testing sort() with many duplicate keys..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
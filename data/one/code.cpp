@@ -5,8 +5,12 @@
 #include "class-bint.hpp"
 #include "list.hpp"
 
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <list>
+#include <sstream>
+#include <vector>
 
 const int N = 5e4;
 
@@ -325,12 +329,172 @@ bool testUnique() {
     return equal(ans, myList);
 }
 
+class CountingList : public sjtu::extensible_list<int> {
+public:
+    int inserts = 0, erases = 0;
+
+    using sjtu::extensible_list<int>::insert;
+
+    iterator insert(iterator pos, const int &value) override {
+        inserts++;
+        return sjtu::extensible_list<int>::insert(pos, value);
+    }
+
+    iterator erase(iterator pos) override {
+        erases++;
+        return sjtu::extensible_list<int>::erase(pos);
+    }
+};
+
+bool testExtensible() {
+    std::list<int> ans;
+    sjtu::extensible_list<int> myList;
+    int range[] = {4, 5, 6};
+    ans.insert(ans.end(), 3, 7), myList.insert(myList.end(), 3, 7);
+    ans.insert(ans.begin(), {1, 2}), myList.insert(myList.begin(), {1, 2});
+    ans.insert(ans.end(), range, range + 3), myList.insert(myList.end(), range, range + 3);
+    ans.insert(ans.end(), 8), myList.insert(myList.end(), 8);
+    ans.erase(ans.begin()), myList.erase(myList.begin());
+    if (!equal(ans, myList))
+        return false;
+
+    CountingList counting;
+    sjtu::extensible_list<int> &ref = counting;
+    for (int i = 0; i < N; ++i)
+        ref.insert(ref.end(), i);
+    for (int i = 0; i < N / 2; ++i)
+        ref.erase(ref.begin());
+    return counting.inserts == N && counting.erases == N / 2 && ref.size() == N - N / 2
+           && *ref.begin() == N / 2;
+}
+
+bool testComparators() {
+    std::list<int> ans1, ans2;
+    sjtu::list<int> myList1, myList2;
+    for (int i = 0; i < N; ++i){
+        int x = rand() % 1000;
+        ans1.push_back(x), myList1.push_back(x);
+        x = rand() % 1000;
+        ans2.push_back(x), myList2.push_back(x);
+    }
+
+    ans1.sort(std::greater<int>()), myList1.sort(std::greater<int>());
+    ans2.sort(std::greater<int>()), myList2.sort(std::greater<int>());
+    if (!equal(ans1, myList1) || !equal(ans2, myList2))
+        return false;
+    ans1.merge(ans2, std::greater<int>()), myList1.merge(myList2, std::greater<int>());
+    if (!myList2.empty() || !equal(ans1, myList1))
+        return false;
+
+    // Ordering by a key leaves equal keys in their original order.
+    auto byTens = [](int a, int b) { return a / 10 < b / 10; };
+    for (int i = 0; i < N; ++i){
+        int x = rand() % 1000;
+        ans2.push_back(x), myList2.push_back(x);
+    }
+    ans2.sort(byTens), myList2.sort(byTens);
+    if (!equal(ans2, myList2))
+        return false;
+
+    auto sameTens = [](int a, int b) { return a / 10 == b / 10; };
+    ans1.unique(sameTens), myList1.unique(sameTens);
+    ans2.unique(sameTens), myList2.unique(sameTens);
+    return equal(ans1, myList1) && equal(ans2, myList2);
+}
+
+bool testSplice() {
+    std::list<int> ans1, ans2;
+    sjtu::list<int> myList1, myList2;
+    for (int i = 0; i < N; ++i){
+        ans1.push_back(i), myList1.push_back(i);
+        ans2.push_back(-i), myList2.push_back(-i);
+    }
+
+    for (int round = 0; round < 100; ++round){
+        int from = rand() % (ans2.size() + 1), len = rand() % (ans2.size() - from + 1);
+        int to = rand() % (ans1.size() + 1);
+        std::list<int>::iterator ansFirst = std::next(ans2.begin(), from), ansLast = std::next(ansFirst, len);
+        sjtu::list<int>::iterator myFirst = myList2.begin(), myLast, myPos = myList1.begin();
+        myFirst.advance(from);
+        myLast = myFirst;
+        myLast.advance(len);
+        myPos.advance(to);
+        ans1.splice(std::next(ans1.begin(), to), ans2, ansFirst, ansLast);
+        // Alternate between passing the length and letting splice count it.
+        if (round % 2 == 0) myList1.splice(myPos, myList2, myFirst, myLast, len);
+        else myList1.splice(myPos, myList2, myFirst, myLast);
+        if (myList1.size() != ans1.size() || myList2.size() != ans2.size())
+            return false;
+        std::swap(ans1, ans2);
+        myList1.swap(myList2);
+    }
+    if (!equal(ans1, myList1) || !equal(ans2, myList2))
+        return false;
+
+    // Within one list the size stays put.
+    sjtu::list<int>::iterator first = myList1.begin(), last = myList1.begin();
+    last.advance(10);
+    myList1.splice(myList1.end(), myList1, first, last, 10);
+    ans1.splice(ans1.end(), ans1, ans1.begin(), std::next(ans1.begin(), 10));
+    myList1.splice(myList1.begin(), myList1, --myList1.end());
+    ans1.splice(ans1.begin(), ans1, --ans1.end());
+    if (!equal(ans1, myList1))
+        return false;
+
+    myList1.splice(myList1.begin(), myList2, myList2.begin());
+    ans1.splice(ans1.begin(), ans2, ans2.begin());
+    myList2.splice(myList2.end(), myList1);
+    ans2.splice(ans2.end(), ans1);
+    return myList1.empty() && myList1.size() == 0 && equal(ans2, myList2) && myList2.size() == 2 * N;
+}
+
+bool testBulk() {
+    std::vector<int> src(N);
+    for (int i = 0; i < N; ++i) src[i] = rand();
+
+    std::list<int> ans1(src.begin(), src.end()), ans2(N / 2, 7), ans3({1, 2, 3});
+    sjtu::list<int> myList1(src.begin(), src.end()), myList2(N / 2, 7), myList3({1, 2, 3});
+    if (!equal(ans1, myList1) || !equal(ans2, myList2) || !equal(ans3, myList3))
+        return false;
+
+    // Single-pass input iterators.
+    std::istringstream in("5 4 3 2 1");
+    sjtu::list<int> myList4((std::istream_iterator<int>(in)), std::istream_iterator<int>());
+    if (myList4.size() != 5 || myList4.front() != 5 || myList4.back() != 1)
+        return false;
+
+    ans1.assign(10, 3), myList1.assign(10, 3);
+    ans2.assign(src.rbegin(), src.rend()), myList2.assign(src.rbegin(), src.rend());
+    ans3.assign({9, 8}), myList3.assign({9, 8});
+    if (!equal(ans1, myList1) || !equal(ans2, myList2) || !equal(ans3, myList3))
+        return false;
+
+    std::list<int>::iterator ansIt = std::next(ans2.begin(), N / 3);
+    sjtu::list<int>::iterator myIt = myList2.begin();
+    myIt.advance(N / 3);
+    ansIt = ans2.insert(ansIt, src.begin(), src.begin() + 100);
+    myIt = myList2.insert(myIt, src.begin(), src.begin() + 100);
+    if (*ansIt != *myIt)
+        return false;
+    ansIt = ans2.insert(ansIt, 5, -1), myIt = myList2.insert(myIt, 5, -1);
+    ansIt = ans2.insert(ansIt, {-2, -3}), myIt = myList2.insert(myIt, {-2, -3});
+    if (*ansIt != *myIt || !equal(ans2, myList2))
+        return false;
+
+    // Empty ranges insert nothing and return pos.
+    myIt = myList2.insert(myIt, src.begin(), src.begin());
+    if (*myIt != -2 || myList2.insert(myList2.end(), 0, 1) != myList2.end())
+        return false;
+    return equal(ans2, myList2);
+}
+
 int main(){
     srand(time(NULL));
     bool (*testList[])() = {
             testConstructors, testAssignment, testPush, testPop, testIterator,
             testBint, testInteger, testMatrix, testElementAccess, testCapacityInfo,
-            testInsert, testErase, testException, testMerge, testReverse, testSort, testUnique
+            testInsert, testErase, testException, testMerge, testReverse, testSort, testUnique,
+            testExtensible, testComparators, testSplice, testBulk
     };
     const char* Messages[] = {
             "Test 1: Testing default & copy constructors and destructor...",
@@ -349,7 +513,11 @@ int main(){
             "Test 14: Testing merge()...",
             "Test 15: Testing reverse()...",
             "Test 16: Testing sort()...",
-            "Test 17: Testing unique()..."
+            "Test 17: Testing unique()...",
+            "Test 18: Testing extensible_list...",
+            "Test 19: Testing sort(), merge() & unique() with comparators...",
+            "Test 20: Testing splice() and size bookkeeping...",
+            "Test 21: Testing range constructors, assign() & range insert()..."
     };
 
     bool okay = true;
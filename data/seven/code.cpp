@@ -0,0 +1,247 @@
+#include "class-integer.hpp"
+#include "class-bint.hpp"
+#include "unrolled_list.hpp"
+
+#include <iostream>
+#include <list>
+#include <string>
+
+const int N = 5e4;
+
+template<typename T, size_t B>
+bool equal(const std::list<T> &x, const sjtu::unrolled_list<T, B> &y) {
+    if (x.size() != y.size())
+        return false;
+
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename sjtu::unrolled_list<T, B>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend() && ity != y.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+    if (itx != x.cend() || ity != y.cend())
+        return false;
+
+    typename std::list<T>::const_reverse_iterator rx = x.crbegin();
+    ity = y.cend();
+    for (; rx != x.crend(); ++rx)
+        if (!(*rx == *--ity))
+            return false;
+
+    return true;
+}
+
+bool testPushPop() {
+    std::list<int> ans;
+    sjtu::unrolled_list<int> myList;
+    for (int i = 0; i < N; ++i) {
+        if (rand() % 2) {
+            ans.push_back(i);
+            myList.push_back(i);
+        } else {
+            ans.push_front(i);
+            myList.push_front(i);
+        }
+    }
+    if (!equal(ans, myList))
+        return false;
+    for (int i = 0; i < N / 2; ++i) {
+        if (rand() % 2) {
+            ans.pop_back();
+            myList.pop_back();
+        } else {
+            ans.pop_front();
+            myList.pop_front();
+        }
+        if (ans.front() != myList.front() || ans.back() != myList.back())
+            return false;
+    }
+    return equal(ans, myList);
+}
+
+bool testInsertErase() {
+    std::list<int> ans;
+    sjtu::unrolled_list<int, 8> myList;
+    for (int i = 0; i < N / 10; ++i) {
+        int pos = ans.empty() ? 0 : rand() % (ans.size() + 1);
+        auto ansIt = ans.begin();
+        auto myIt = myList.begin();
+        for (int j = 0; j < pos; ++j) ++ansIt, ++myIt;
+        if (ans.empty() || rand() % 3) {
+            ansIt = ans.insert(ansIt, i);
+            myIt = myList.insert(myIt, i);
+        } else {
+            if (ansIt == ans.end()) --ansIt, --myIt;
+            ansIt = ans.erase(ansIt);
+            myIt = myList.erase(myIt);
+        }
+        if ((ansIt == ans.end()) != (myIt == myList.end()))
+            return false;
+        if (ansIt != ans.end() && *ansIt != *myIt)
+            return false;
+    }
+    return equal(ans, myList);
+}
+
+bool testCopyAssign() {
+    std::list<Integer> ans;
+    sjtu::unrolled_list<Integer> myList;
+    for (int i = 0; i < N; ++i) {
+        ans.push_back(Integer(i));
+        myList.push_back(Integer(i));
+    }
+    sjtu::unrolled_list<Integer> other(myList);
+    sjtu::unrolled_list<Integer> third;
+    third = other;
+    third = third;
+    sjtu::unrolled_list<Integer> moved(std::move(other));
+    return equal(ans, myList) && equal(ans, third) && equal(ans, moved) && other.empty();
+}
+
+bool testSortMergeUnique() {
+    std::list<int> ans1, ans2;
+    sjtu::unrolled_list<int> myList1, myList2;
+    for (int i = 0; i < N; ++i) {
+        int x = rand() % 1000;
+        ans1.push_back(x);
+        myList1.push_back(x);
+        x = rand() % 1000;
+        ans2.push_front(x);
+        myList2.push_front(x);
+    }
+    ans1.sort(), myList1.sort();
+    ans2.sort(), myList2.sort();
+    if (!equal(ans1, myList1) || !equal(ans2, myList2))
+        return false;
+    ans1.merge(ans2), myList1.merge(myList2);
+    if (!equal(ans1, myList1) || !myList2.empty())
+        return false;
+    ans1.unique(), myList1.unique();
+    if (!equal(ans1, myList1))
+        return false;
+    ans1.sort([](int a, int b) { return a > b; });
+    myList1.sort([](int a, int b) { return a > b; });
+    return equal(ans1, myList1);
+}
+
+bool testReverse() {
+    std::list<Util::Bint> ans;
+    sjtu::unrolled_list<Util::Bint, 5> myList;
+    for (int i = 0; i < N / 30; ++i) {
+        ans.push_back(Util::Bint(i) * Util::Bint(rand()));
+        myList.push_back(ans.back());
+        if (rand() % 50 == 0) {
+            ans.reverse();
+            myList.reverse();
+        }
+    }
+    return equal(ans, myList);
+}
+
+bool testException() {
+    sjtu::unrolled_list<int> myList, otherList;
+    int ans = 0;
+
+    try{ myList.pop_back(); } catch (...) { ans++; }
+    try{ myList.pop_front(); } catch (...) { ans++; }
+    try{ myList.front(); } catch (...) { ans++; }
+    try{ myList.back(); } catch (...) { ans++; }
+    sjtu::unrolled_list<int>::iterator it = myList.end(), oit = otherList.end();
+    try{ *it; } catch (...) { ans++; }
+    try{ it--; } catch (...) { ans++; }
+    try{ it++; } catch (...) { ans++; }
+    try{ myList.erase(it); } catch (...) { ans++; }
+    try{ myList.insert(oit, 0); } catch (...) { ans++; }
+
+    return ans == 9;
+}
+
+bool testSelfReference() {
+    // Arguments that refer into a full chunk must survive the split they cause.
+    std::list<std::string> ans;
+    sjtu::unrolled_list<std::string, 4> myList;
+    for (int i = 0; i < 500; ++i) {
+        std::string s(40, char('a' + i % 26));
+        if (ans.empty() || i % 3 == 0) {
+            ans.push_back(s);
+            myList.push_back(s);
+            continue;
+        }
+        int from = rand() % ans.size(), to = rand() % (ans.size() + 1);
+        auto ansFrom = ans.begin(), ansTo = ans.begin();
+        auto myFrom = myList.begin(), myTo = myList.begin();
+        for (int j = 0; j < from; ++j) ++ansFrom, ++myFrom;
+        for (int j = 0; j < to; ++j) ++ansTo, ++myTo;
+        ans.insert(ansTo, *ansFrom);
+        myList.insert(myTo, *myFrom);
+    }
+    // The case that used to fail: a full chunk, inserting its own last
+    // element in front of its third.
+    sjtu::unrolled_list<std::string, 4> full;
+    std::list<std::string> fullAns = {"aaa", "bbb", "ccc", "ddd"};
+    for (const std::string &s : fullAns) full.push_back(s);
+    auto pos = full.begin(), last = full.begin();
+    ++pos, ++pos;
+    ++last, ++last, ++last;
+    full.insert(pos, *last);
+    fullAns.insert(std::next(fullAns.begin(), 2), "ddd");
+    return equal(ans, myList) && equal(fullAns, full);
+}
+
+bool testSortThrow() {
+    // A comparator that throws must leave the list as it was, leak-free.
+    std::list<std::string> ans;
+    sjtu::unrolled_list<std::string, 8> myList;
+    for (int i = 0; i < 100; ++i) {
+        std::string s = std::to_string(rand() % 1000) + std::string(30, 'x');
+        ans.push_back(s);
+        myList.push_back(s);
+    }
+    for (int budget : {0, 10, 200, 500}) {
+        int left = budget;
+        try {
+            myList.sort([&left](const std::string &a, const std::string &b) {
+                if (left-- == 0) throw 0;
+                return a < b;
+            });
+            return false;
+        } catch (int) {}
+        if (!equal(ans, myList))
+            return false;
+    }
+    ans.sort(), myList.sort();
+    return equal(ans, myList);
+}
+
+int main(){
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testPushPop, testInsertErase, testCopyAssign, testSortMergeUnique, testReverse, testException,
+            testSelfReference, testSortThrow
+    };
+    const char* Messages[] = {
+            "Test 1: Testing push & pop...",
+            "Test 2: Testing insert() & erase()...",
+            "Test 3: Testing copy, assignment & move...",
+            "Test 4: Testing sort(), merge() & unique()...",
+            "Test 5: Testing reverse()...",
+            "Test 6: Testing exception throw...",
+            "Test 7: Testing arguments that refer into the list...",
+            "Test 8: Testing sort() with a throwing comparator..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,232 @@
+// Pooled lists: slab reuse, shrink(), clear(), pool sharing and copies.
+
+#include "list.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <list>
+#include <set>
+#include <thread>
+
+const int N = 1e4;
+const size_t SLAB = 64;
+
+template<typename T>
+bool equal(const std::list<T> &x, const sjtu::list<T> &y) {
+    if (x.size() != y.size())
+        return false;
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename sjtu::list<T>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+    return true;
+}
+
+bool testReuse() {
+    sjtu::list<int> myList;
+    myList.enable_pool(SLAB);
+    if (!myList.pooled())
+        return false;
+    std::set<const int *> seen;
+    for (int i = 0; i < N; ++i) {
+        myList.push_back(i);
+        seen.insert(&myList.back());
+    }
+    while (!myList.empty())
+        myList.pop_front();
+
+    // Freed nodes are handed out again before any new slab is carved.
+    for (int i = 0; i < N; ++i) {
+        myList.push_front(i);
+        if (seen.count(&myList.front()) == 0)
+            return false;
+    }
+    return myList.size() == N && myList.front() == N - 1;
+}
+
+bool testShrink() {
+    sjtu::list<int> myList;
+    myList.enable_pool(SLAB);
+    for (int i = 0; i < N; ++i)
+        myList.push_back(i);
+    if (myList.shrink() != 0)
+        return false;
+
+    while (!myList.empty())
+        myList.pop_back();
+    size_t slabs = myList.shrink(2);
+    if (slabs < 2 || myList.shrink(2) != 0 || myList.shrink() != 2 || myList.shrink() != 0)
+        return false;
+    // Each slab holds at least SLAB nodes.
+    if (slabs + 2 > N / SLAB + 1)
+        return false;
+
+    // Only slabs with no live node are idle.
+    for (int i = 0; i < N; ++i)
+        myList.push_back(i);
+    while (myList.size() > 1)
+        myList.pop_back();
+    size_t idle = myList.shrink();
+    if (idle != slabs + 1 || myList.front() != 0)
+        return false;
+
+    sjtu::list<int> plain;
+    plain.push_back(1);
+    return !plain.pooled() && plain.shrink() == 0;
+}
+
+bool testClear() {
+    sjtu::list<int> myList;
+    myList.enable_pool(SLAB);
+    for (int i = 0; i < N; ++i)
+        myList.push_back(i);
+    myList.clear();
+    if (myList.shrink() != 0 || !myList.empty())
+        return false;
+
+    // A shared pool keeps the slabs the other list still uses.
+    for (int i = 0; i < N; ++i)
+        myList.push_back(i);
+    sjtu::list<int> copy;
+    copy.enable_pool(myList);
+    copy = myList;
+    myList.clear();
+    if (myList.shrink() != 0 || copy.size() != N || copy.back() != N - 1)
+        return false;
+    for (int i = 0; i < N; ++i)
+        myList.push_back(-i);
+    copy.clear();
+    myList.clear();
+    return myList.shrink() == 0 && copy.pooled() && myList.pooled();
+}
+
+bool testSharedPool() {
+    std::list<int> ans1, ans2;
+    sjtu::list<int> myList1;
+    myList1.enable_pool(SLAB);
+    for (int i = 0; i < N; ++i) {
+        int x = rand() % N;
+        ans1.push_back(x);
+        myList1.push_back(x);
+    }
+    sjtu::list<int> myList2, myList3;
+    ans2 = ans1;
+    myList2.enable_pool(myList1);
+    myList2 = myList1;
+    myList3.enable_pool(myList1);
+    if (!myList2.pooled() || !myList3.pooled())
+        return false;
+    for (int i = 0; i < N; ++i)
+        myList3.push_back(i);
+
+    ans1.sort(), myList1.sort();
+    ans2.sort(), myList2.sort();
+    ans1.merge(ans2), myList1.merge(myList2);
+    if (!myList2.empty() || !equal(ans1, myList1))
+        return false;
+
+    std::list<int> ans3;
+    for (int i = 0; i < N; ++i)
+        ans3.push_back(i);
+    sjtu::list<int>::iterator it = myList3.begin();
+    it.advance(N / 2);
+    ans1.splice(ans1.begin(), ans3, std::next(ans3.begin(), N / 2), ans3.end());
+    myList1.splice(myList1.begin(), myList3, it, myList3.end());
+    ans1.splice(ans1.end(), ans3);
+    myList1.splice(myList1.end(), myList3);
+    return myList3.empty() && equal(ans1, myList1);
+}
+
+bool testForeignPool() {
+    sjtu::list<int> a, b, plain;
+    a.enable_pool(SLAB);
+    b.enable_pool(SLAB);
+    for (int i = 0; i < 10; ++i) {
+        a.push_back(i);
+        b.push_back(i);
+        plain.push_back(i);
+    }
+
+    int thrown = 0;
+    try { a.splice(a.end(), b); } catch (sjtu::runtime_error &) { thrown++; }
+    try { a.splice(a.end(), b, b.begin()); } catch (sjtu::runtime_error &) { thrown++; }
+    try { a.splice(a.end(), b, b.begin(), b.end()); } catch (sjtu::runtime_error &) { thrown++; }
+    try { a.merge(b); } catch (sjtu::runtime_error &) { thrown++; }
+    try { a.merge(plain); } catch (sjtu::runtime_error &) { thrown++; }
+    try { plain.splice(plain.begin(), a); } catch (sjtu::runtime_error &) { thrown++; }
+    try { a.enable_pool(SLAB); } catch (sjtu::runtime_error &) { thrown++; }
+    try { plain.enable_pool(a); } catch (sjtu::runtime_error &) { thrown++; }
+    if (thrown != 8)
+        return false;
+
+    // Nothing moved, and an empty foreign list is still fine to merge.
+    sjtu::list<int> empty;
+    a.merge(empty);
+    return a.size() == 10 && b.size() == 10 && plain.size() == 10 && a.back() == 9;
+}
+
+bool testCopyOwnPool() {
+    // Copies look independent, so they must not share the slab pool: each
+    // is filled and emptied on its own thread while the original is too.
+    sjtu::list<int> myList;
+    myList.enable_pool(SLAB);
+    for (int i = 0; i < N; ++i)
+        myList.push_back(i);
+    sjtu::list<int> copy1(myList), copy2(myList);
+    if (!copy1.pooled() || !copy2.pooled() || copy1.size() != N || copy2.back() != N - 1)
+        return false;
+
+    auto churn = [](sjtu::list<int> *l) {
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < N; ++i)
+                l->push_front(i);
+            for (int i = 0; i < N; ++i)
+                l->pop_front();
+            l->shrink();
+        }
+    };
+    std::thread t1(churn, &copy1), t2(churn, &copy2);
+    churn(&myList);
+    t1.join(), t2.join();
+    if (myList.size() != N || copy1.size() != N || copy2.size() != N)
+        return false;
+
+    int thrown = 0;
+    try { myList.merge(copy1); } catch (sjtu::runtime_error &) { thrown++; }
+    try { myList.splice(myList.end(), copy2); } catch (sjtu::runtime_error &) { thrown++; }
+    return thrown == 2 && copy1.back() == N - 1;
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testReuse, testShrink, testClear, testSharedPool, testForeignPool,
+            testCopyOwnPool
+    };
+    const char *Messages[] = {
+            "Test 1: Testing pooled nodes are reused...",
+            "Test 2: Testing shrink() and idle slabs...",
+            "Test 3: Testing clear() releases slabs...",
+            "Test 4: Testing enable_pool(peer) shares a pool for merge() & splice()...",
+            "Test 5: Testing splice() & merge() across pools throw...",
+            "Test 6: Testing copies get a pool of their own..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
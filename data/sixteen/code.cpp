@@ -0,0 +1,171 @@
+// Built with SJTU_LIST_CHECKED=0: the same operations through unchecked
+// iterators, which must behave like the checked ones on valid use.
+
+#include "list.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <list>
+
+#if SJTU_LIST_CHECKED
+#error "data/sixteen must be built with SJTU_LIST_CHECKED=0"
+#endif
+
+const int N = 5e4;
+
+template<typename T>
+bool equal(const std::list<T> &x, const sjtu::list<T> &y) {
+    if (x.size() != y.size())
+        return false;
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename sjtu::list<T>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+    typename sjtu::list<T>::const_iterator back = y.cend();
+    for (typename std::list<T>::const_reverse_iterator rit = x.crbegin(); rit != x.crend(); ++rit)
+        if (!(*rit == *--back))
+            return false;
+    return back == y.cbegin();
+}
+
+bool testLayout() {
+    return sizeof(sjtu::list<int>::iterator) == sizeof(void *)
+           && sizeof(sjtu::list<int>::const_iterator) == sizeof(void *);
+}
+
+bool testIterator() {
+    std::list<int> ans;
+    sjtu::list<int> myList;
+    for (int i = 0; i < N; ++i) {
+        ans.push_back(i);
+        myList.push_back(i);
+    }
+
+    std::list<int>::iterator ansIt = ans.begin();
+    sjtu::list<int>::iterator myIt = myList.begin();
+    for (int i = 0; i < N / 4; ++i) {
+        if (*(ansIt++) != *(myIt++))
+            return false;
+        if (*(++ansIt) != *(++myIt))
+            return false;
+    }
+    for (int i = 0; i < N / 8; ++i) {
+        if (*(ansIt--) != *(myIt--))
+            return false;
+        if (*(--ansIt) != *(--myIt))
+            return false;
+    }
+
+    sjtu::list<int>::const_iterator cIt(myIt);
+    if (cIt != myIt || myIt != cIt)
+        return false;
+    ++myIt;
+    return cIt != myIt && *myIt == *cIt + 1;
+}
+
+bool testInsertErase() {
+    std::list<int> ans;
+    sjtu::list<int> myList;
+    std::list<int>::iterator ansIt = ans.end();
+    sjtu::list<int>::iterator myIt = myList.end();
+    for (int i = 0; i < N; ++i) {
+        int op = rand() % 4;
+        if (op < 2 || ans.empty()) {
+            ansIt = ans.insert(ansIt, i);
+            myIt = myList.insert(myIt, i);
+        } else if (op == 2 && ansIt != ans.end()) {
+            ansIt = ans.erase(ansIt);
+            myIt = myList.erase(myIt);
+        } else {
+            ansIt = ans.begin();
+            myIt = myList.begin();
+        }
+    }
+    return equal(ans, myList);
+}
+
+bool testReverse() {
+    std::list<int> ans;
+    sjtu::list<int> myList;
+    for (int i = 0; i < N; ++i) {
+        ans.push_back(i);
+        myList.push_back(i);
+    }
+
+    // An iterator kept across reverse() still points at its element and
+    // walks in the list's new direction, as a checked one would.
+    sjtu::list<int>::iterator kept = myList.begin();
+    kept.advance(N / 2);
+    ans.reverse(), myList.reverse();
+    if (*kept != N / 2 || *++kept != N / 2 - 1)
+        return false;
+    myList.insert(kept, -1);
+    std::list<int>::iterator ansIt = ans.begin();
+    std::advance(ansIt, N / 2);
+    ans.insert(ansIt, -1);
+    if (!equal(ans, myList))
+        return false;
+
+    myList.pop_front(), ans.pop_front();
+    myList.push_back(N), ans.push_back(N);
+    ans.reverse(), myList.reverse();
+    return equal(ans, myList);
+}
+
+bool testSpliceSort() {
+    std::list<int> ans1, ans2;
+    sjtu::list<int> myList1, myList2;
+    for (int i = 0; i < N; ++i) {
+        int x = rand() % N;
+        ans1.push_back(x);
+        myList1.push_back(x);
+        ans2.push_front(x / 3);
+        myList2.push_front(x / 3);
+    }
+    ans2.reverse(), myList2.reverse();
+
+    std::list<int>::iterator ansIt = ans1.begin();
+    sjtu::list<int>::iterator myIt = myList1.begin();
+    std::advance(ansIt, N / 3);
+    myIt.advance(N / 3);
+    ans1.splice(ansIt, ans2, ans2.begin(), ans2.end());
+    myList1.splice(myIt, myList2, myList2.begin(), myList2.end());
+    if (!myList2.empty() || !equal(ans1, myList1))
+        return false;
+
+    ans1.sort(), myList1.sort();
+    ans1.unique(), myList1.unique();
+    return equal(ans1, myList1);
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testLayout, testIterator, testInsertErase, testReverse, testSpliceSort
+    };
+    const char *Messages[] = {
+            "Test 1: Testing unchecked iterators are a bare pointer...",
+            "Test 2: Testing unchecked iterator operations...",
+            "Test 3: Testing insert() & erase() through unchecked iterators...",
+            "Test 4: Testing reverse() with unchecked iterators...",
+            "Test 5: Testing splice(), sort() & unique() with unchecked iterators..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include "class-integer.hpp"
+#include "mpsc_list_queue.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int Producers = 6;
+const int N = 5e4;
+
+bool testSingleThread() {
+    sjtu::mpsc_list_queue<int> queue;
+    int out, expect = 0;
+    if (!queue.empty() || queue.pop_front(out))
+        return false;
+    for (int i = 0; i < N; ++i) {
+        queue.push_back(i);
+        if (i % 3 == 0) {
+            if (!queue.pop_front(out) || out != expect++)
+                return false;
+        }
+    }
+    while (queue.pop_front(out))
+        if (out != expect++)
+            return false;
+    return queue.empty() && expect == N;
+}
+
+bool testDrainInto() {
+    sjtu::mpsc_list_queue<std::string> queue(4);
+    sjtu::list<std::string> myList;
+    myList.push_back("head");
+    if (queue.drain_into(myList) != 0 || myList.size() != 1)
+        return false;
+    for (int i = 0; i < 100; ++i)
+        queue.push_back(std::to_string(i));
+    if (queue.drain_into(myList) != 100 || myList.size() != 101 || !queue.empty())
+        return false;
+    queue.push_back("tail");
+    queue.drain_into(myList);
+    int i = -1;
+    for (auto it = myList.begin(); it != myList.end(); ++it, ++i) {
+        std::string want = i < 0 ? "head" : i == 100 ? "tail" : std::to_string(i);
+        if (*it != want)
+            return false;
+    }
+    auto it = myList.end();
+    for (int k = 0; k < 102; ++k) --it;
+    return it == myList.begin() && myList.back() == "tail";
+}
+
+bool testConcurrent() {
+    sjtu::mpsc_list_queue<long> queue(256);
+    std::atomic<int> finished(0);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < Producers; ++t) {
+        producers.emplace_back([&queue, &finished, t] {
+            for (int i = 0; i < N; ++i)
+                queue.push_back((long)t * N + i);
+            finished++;
+        });
+    }
+    // Per producer, values must arrive in the order they were pushed.
+    std::vector<long> next(Producers, 0);
+    sjtu::list<long> batch;
+    long received = 0;
+    bool ok = true;
+    while (true) {
+        bool done = finished == Producers;
+        long v;
+        if (rand() % 2) {
+            while (queue.pop_front(v)) {
+                ok = ok && v % N == next[v / N]++;
+                received++;
+            }
+        } else {
+            queue.drain_into(batch);
+            while (!batch.empty()) {
+                v = batch.front();
+                batch.pop_front();
+                ok = ok && v % N == next[v / N]++;
+                received++;
+            }
+        }
+        if (done && queue.empty())
+            break;
+    }
+    for (auto &p : producers)
+        p.join();
+    return ok && received == (long)Producers * N;
+}
+
+struct Counted {
+    static int live;
+    Integer value;
+
+    Counted(int v) : value(v) { live++; }
+    Counted(const Counted &other) : value(other.value) { live++; }
+    Counted &operator=(const Counted &other) {
+        value = other.value;
+        return *this;
+    }
+    ~Counted() { live--; }
+};
+
+int Counted::live = 0;
+
+bool testNonTrivial() {
+    {
+        sjtu::mpsc_list_queue<Counted> queue(8);
+        for (int i = 0; i < 100; ++i)
+            queue.push_back(Counted(i));
+        Counted out(0);
+        for (int i = 0; i < 50; ++i)
+            if (!queue.pop_front(out) || !(out.value == Integer(i)))
+                return false;
+        for (int i = 0; i < 20; ++i)
+            queue.emplace_back(i);
+        if (Counted::live != 71)
+            return false;
+    }
+    return Counted::live == 0;
+}
+
+bool testException() {
+    sjtu::mpsc_list_queue<int> queue;
+    sjtu::list<int> pooled;
+    pooled.enable_pool();
+    queue.push_back(1);
+    try {
+        queue.drain_into(pooled);
+    } catch (...) {
+        int out;
+        return queue.pop_front(out) && out == 1;
+    }
+    return false;
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testSingleThread, testDrainInto, testConcurrent, testNonTrivial, testException
+    };
+    const char *Messages[] = {
+            "Test 1: Testing push_back() & pop_front()...",
+            "Test 2: Testing drain_into()...",
+            "Test 3: Testing concurrent producers...",
+            "Test 4: Testing non-trivial values & node recycling...",
+            "Test 5: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
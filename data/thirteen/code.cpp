@@ -0,0 +1,157 @@
+#include "list.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+const int N = 1e5;
+
+bool testAt() {
+    sjtu::list<int> myList;
+    std::vector<int> ans;
+    for (int i = 0; i < N; ++i) {
+        myList.push_back(i);
+        ans.push_back(i);
+    }
+    // Sequential scans, both ways, must not walk from the front every time.
+    long long sum = 0;
+    for (int i = 0; i < N; ++i) {
+        myList[i] *= 3;
+        ans[i] *= 3;
+    }
+    for (int i = N - 1; i >= 0; --i)
+        if (myList.at(i) != ans[i])
+            return false;
+    // Const lookups leave the cursor alone, so these walk from the nearer
+    // end or from wherever the last non-const lookup stopped.
+    const sjtu::list<int> &view = myList;
+    for (int i = 0; i < 1000; ++i) {
+        int k = rand() % N;
+        sum += myList.at(k) - ans[k];
+        sum += view[k] - ans[k];
+    }
+    if (view.at(0) != ans[0] || view.at(N - 1) != ans[N - 1])
+        return false;
+    try {
+        myList.at(N);
+        return false;
+    } catch (sjtu::index_out_of_bound &) {}
+    return sum == 0;
+}
+
+bool testAtAfterUpdates() {
+    sjtu::list<int> myList;
+    std::vector<int> ans;
+    for (int i = 0; i < N / 10; ++i) {
+        size_t k = rand() % (ans.size() + 1);
+        int x = rand();
+        if (rand() % 4 == 0 && !ans.empty()) {
+            k %= ans.size();
+            myList.erase(myList.nth(k));
+            ans.erase(ans.begin() + k);
+        } else {
+            myList.insert(k == ans.size() ? myList.end() : myList.nth(k), x);
+            ans.insert(ans.begin() + k, x);
+        }
+        if (!ans.empty()) {
+            k = rand() % ans.size();
+            if (myList[k] != ans[k])
+                return false;
+        }
+        if (i % 1000 == 999) {
+            myList.reverse();
+            std::reverse(ans.begin(), ans.end());
+        }
+    }
+    return true;
+}
+
+bool testAdvanceDistance() {
+    sjtu::list<int> myList;
+    for (int i = 0; i < N; ++i)
+        myList.push_back(i);
+    for (int t = 0; t < 200; ++t) {
+        int i = rand() % (N + 1), j = i + rand() % (N + 1 - i);
+        sjtu::list<int>::iterator first = myList.begin();
+        first.advance(i);
+        sjtu::list<int>::iterator last = first;
+        last.advance(j - i);
+        if ((i < N && *first != i) || (j < N && *last != j))
+            return false;
+        if (myList.distance(first, last) != (size_t)(j - i))
+            return false;
+        last.advance(i - j);
+        if (last != first)
+            return false;
+    }
+    if (myList.distance(myList.begin(), myList.end()) != (size_t)N)
+        return false;
+    sjtu::list<int>::iterator it = myList.begin();
+    it.advance(10);
+    try {
+        myList.distance(it, myList.begin());
+        return false;
+    } catch (sjtu::invalid_iterator &) {}
+    return true;
+}
+
+// The positional cursor lives outside the list, which stays six words.
+static_assert(sizeof(sjtu::list<int>) <= 6 * sizeof(void *), "");
+
+bool testConstReaders() {
+    sjtu::list<int> myList;
+    for (int i = 0; i < N / 10; ++i)
+        myList.push_back(i);
+    myList.at(N / 20);
+    const sjtu::list<int> &view = myList;
+
+    // Const lookups write nothing, so readers may share the list.
+    std::atomic<int> errors(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&view, &errors, t]() {
+            unsigned seed = t + 1;
+            for (int i = 0; i < 2000; ++i) {
+                seed = seed * 1103515245 + 12345;
+                int k = (seed >> 8) % (N / 10);
+                if (view[k] != k) errors++;
+            }
+        });
+    }
+    for (std::thread &reader : readers)
+        reader.join();
+    return errors == 0;
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testAt, testAtAfterUpdates, testAdvanceDistance, testConstReaders
+    };
+    const char *Messages[] = {
+            "Test 1: Testing at() & operator[]...",
+            "Test 2: Testing at() between inserts & erases...",
+            "Test 3: Testing advance() & distance()...",
+            "Test 4: Testing const at() from concurrent readers..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
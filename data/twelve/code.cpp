@@ -0,0 +1,213 @@
+#include "list.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <thread>
+#include <vector>
+
+const int N = 5e4;
+
+template<typename T>
+bool equal(const sjtu::list<T> &x, const std::vector<T> &y) {
+    if (x.size() != y.size())
+        return false;
+    size_t i = 0;
+    for (typename sjtu::list<T>::const_iterator it = x.cbegin(); it != x.cend(); ++it)
+        if (!(*it == y[i++]))
+            return false;
+    return true;
+}
+
+bool testInsertSorted() {
+    sjtu::list<int> myList;
+    myList.enable_index();
+    std::vector<int> ans;
+    for (int i = 0; i < N; ++i) {
+        int x = rand() % N;
+        sjtu::list<int>::iterator it = myList.insert_sorted(x);
+        std::vector<int>::iterator pos = std::upper_bound(ans.begin(), ans.end(), x);
+        size_t k = pos - ans.begin();
+        ans.insert(pos, x);
+        if (*it != x || myList.index_of(it) != k)
+            return false;
+    }
+    return equal(myList, ans);
+}
+
+bool testPositional() {
+    sjtu::list<int> myList;
+    myList.enable_index();
+    std::vector<int> ans;
+    for (int i = 0; i < N; ++i) {
+        int x = rand();
+        if (ans.empty() || rand() % 3) {
+            size_t k = rand() % (ans.size() + 1);
+            myList.insert(k == ans.size() ? myList.end() : myList.nth(k), x);
+            ans.insert(ans.begin() + k, x);
+        } else {
+            size_t k = rand() % ans.size();
+            myList.erase(myList.nth(k));
+            ans.erase(ans.begin() + k);
+        }
+    }
+    for (size_t k = 0; k < ans.size(); k += 7)
+        if (*myList.nth(k) != ans[k] || myList.index_of(myList.nth(k)) != k)
+            return false;
+    if (myList.index_of(myList.end()) != ans.size())
+        return false;
+    try {
+        myList.nth(ans.size());
+        return false;
+    } catch (sjtu::index_out_of_bound &) {}
+    return equal(myList, ans);
+}
+
+bool testLookup() {
+    sjtu::list<int> myList;
+    myList.enable_index();
+    std::vector<int> ans;
+    for (int i = 0; i < N; ++i) {
+        int x = rand() % (2 * N) * 2;
+        myList.insert_sorted(x);
+        ans.insert(std::upper_bound(ans.begin(), ans.end(), x), x);
+    }
+    for (int i = 0; i < N; ++i) {
+        int x = rand() % (4 * N + 4);
+        size_t k = std::lower_bound(ans.begin(), ans.end(), x) - ans.begin();
+        if (myList.index_of(myList.lower_bound(x)) != k)
+            return false;
+        sjtu::list<int>::iterator it = myList.find_sorted(x);
+        bool found = std::binary_search(ans.begin(), ans.end(), x);
+        if ((it != myList.end()) != found || (found && *it != x))
+            return false;
+    }
+    return true;
+}
+
+bool testBulkOperations() {
+    sjtu::list<int> myList, other;
+    myList.enable_index();
+    other.enable_index();
+    std::vector<int> ans;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < N / 20; ++i) {
+            int x = rand() % 1000;
+            other.insert_sorted(x);
+            ans.push_back(x);
+        }
+        std::sort(ans.begin(), ans.end());
+        myList.merge(other);
+        if (!other.empty() || myList.index_of(myList.lower_bound(500)) !=
+                              (size_t)(std::lower_bound(ans.begin(), ans.end(), 500) - ans.begin()))
+            return false;
+        if (round % 4 == 3) {
+            myList.unique();
+            ans.erase(std::unique(ans.begin(), ans.end()), ans.end());
+        }
+        sjtu::list<int> moved(std::move(myList));
+        myList.swap(moved);
+        for (int i = 0; i < 10; ++i) {
+            size_t k = rand() % ans.size();
+            if (*myList.nth(k) != ans[k])
+                return false;
+            myList.erase(myList.nth(k));
+            ans.erase(ans.begin() + k);
+        }
+    }
+    myList.reverse();
+    std::reverse(ans.begin(), ans.end());
+    for (size_t k = 0; k < ans.size(); k += 13)
+        if (*myList.nth(k) != ans[k])
+            return false;
+    return equal(myList, ans);
+}
+
+bool testUnindexed() {
+    sjtu::list<int> myList;
+    std::vector<int> ans;
+    for (int i = 0; i < N / 50; ++i) {
+        int x = rand() % 100;
+        myList.insert_sorted(x, std::greater<int>());
+        ans.insert(std::upper_bound(ans.begin(), ans.end(), x, std::greater<int>()), x);
+    }
+    if (myList.indexed() || !equal(myList, ans))
+        return false;
+    for (size_t k = 0; k < ans.size(); ++k)
+        if (*myList.nth(k) != ans[k] || myList.index_of(myList.nth(k)) != k)
+            return false;
+    myList.enable_index();
+    for (int x = 0; x < 100; ++x) {
+        size_t k = std::lower_bound(ans.begin(), ans.end(), x, std::greater<int>()) - ans.begin();
+        if (myList.index_of(myList.lower_bound(x, std::greater<int>())) != k)
+            return false;
+    }
+    myList.disable_index();
+    return !myList.indexed() && equal(myList, ans);
+}
+
+bool testConstReaders() {
+    // After a bulk operation the index is stale. Const index_of() and
+    // distance() must walk instead of rebuilding it, so readers on several
+    // threads can share the list.
+    sjtu::list<int> myList;
+    myList.enable_index();
+    for (int i = 0; i < N / 5; ++i)
+        myList.push_back(rand());
+    myList.sort();
+    std::vector<sjtu::list<int>::const_iterator> its;
+    for (auto it = myList.cbegin(); it != myList.cend(); ++it)
+        its.push_back(it);
+    const sjtu::list<int> &view = myList;
+    bool ok[4] = {};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t] {
+            ok[t] = true;
+            for (size_t k = t; k < its.size(); k += 97) {
+                if (view.index_of(its[k]) != k || view.distance(its[0], its[k]) != k)
+                    ok[t] = false;
+            }
+        });
+    }
+    for (std::thread &reader : readers)
+        reader.join();
+    for (int t = 0; t < 4; ++t)
+        if (!ok[t])
+            return false;
+    return myList.index_of(its.back()) == its.size() - 1;
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testInsertSorted, testPositional, testLookup, testBulkOperations, testUnindexed,
+            testConstReaders
+    };
+    const char *Messages[] = {
+            "Test 1: Testing insert_sorted() & index_of()...",
+            "Test 2: Testing nth() with inserts & erases...",
+            "Test 3: Testing lower_bound() & find_sorted()...",
+            "Test 4: Testing the index through merge(), unique() & moves...",
+            "Test 5: Testing lookups without an index...",
+            "Test 6: Testing const lookups on a stale index from several threads..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Parallel sjtu::sort for arrays and sjtu::list: thread counts, the serial
+// cutoff and deterministic output.
+
+#include "list.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <utility>
+#include <vector>
+
+const int N = 2e5;
+
+typedef std::pair<int, int> Item;
+
+std::vector<Item> items(int n, int keys) {
+    std::vector<Item> v(n);
+    for (int i = 0; i < n; ++i) v[i] = Item(rand() % keys, i);
+    return v;
+}
+
+// Orders by key only, so equal keys expose how ties are placed.
+struct ByKey {
+    bool operator()(const Item &a, const Item &b) const {
+        return a.first < b.first;
+    }
+};
+
+// Notes whether any comparison ran off the calling thread.
+struct Watching {
+    std::thread::id home;
+    std::atomic<bool> *away;
+
+    bool operator()(const Item &a, const Item &b) const {
+        if (std::this_thread::get_id() != home) away->store(true, std::memory_order_relaxed);
+        return a.first < b.first;
+    }
+};
+
+bool equalKeys(const std::vector<Item> &a, const std::vector<Item> &b) {
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].first != b[i].first)
+            return false;
+    return a.size() == b.size();
+}
+
+bool equal(const std::vector<Item> &a, const sjtu::list<Item> &b) {
+    if (a.size() != b.size())
+        return false;
+    sjtu::list<Item>::const_iterator it = b.cbegin();
+    for (size_t i = 0; i < a.size(); ++i, ++it)
+        if (a[i] != *it)
+            return false;
+    return true;
+}
+
+bool testArrayThreads() {
+    std::vector<Item> src = items(N, N);
+    std::vector<Item> ans = src;
+    std::stable_sort(ans.begin(), ans.end(), ByKey());
+    const size_t threads[] = {1, 2, 3, 8, 0};
+    for (size_t t : threads) {
+        std::vector<Item> a = src;
+        sjtu::sort(sjtu::parallel_policy(t, 1000), a.begin(), a.end(), ByKey());
+        if (!equalKeys(ans, a))
+            return false;
+    }
+    std::vector<int> ints(N);
+    for (int i = 0; i < N; ++i) ints[i] = rand();
+    std::vector<int> ansInts = ints;
+    std::sort(ansInts.begin(), ansInts.end());
+    sjtu::sort(sjtu::parallel_policy(4, 1000), ints.begin(), ints.end());
+    return ints == ansInts;
+}
+
+bool testArrayDeterministic() {
+    std::vector<Item> src = items(N, 100);
+    std::vector<Item> first = src;
+    sjtu::sort(sjtu::parallel_policy(4, 1000), first.begin(), first.end(), ByKey());
+    for (int round = 0; round < 5; ++round) {
+        std::vector<Item> again = src;
+        sjtu::sort(sjtu::parallel_policy(4, 1000), again.begin(), again.end(), ByKey());
+        if (again != first)
+            return false;
+    }
+    return true;
+}
+
+bool testArrayCutoff() {
+    std::vector<Item> src = items(N, N);
+    std::atomic<bool> away(false);
+    std::vector<Item> a = src;
+    sjtu::sort(sjtu::parallel_policy(4, N + 1), a.begin(), a.end(), Watching{std::this_thread::get_id(), &away});
+    if (away)
+        return false;
+    a = src;
+    sjtu::sort(sjtu::parallel_policy(4, 1000), a.begin(), a.end(), Watching{std::this_thread::get_id(), &away});
+    return away && std::is_sorted(a.begin(), a.end(), ByKey());
+}
+
+bool testListThreads() {
+    std::vector<Item> src = items(N, 1000);
+    std::vector<Item> ans = src;
+    std::stable_sort(ans.begin(), ans.end(), ByKey());
+    const size_t threads[] = {1, 2, 3, 8, 0};
+    for (size_t t : threads) {
+        // The list sort is stable, so the output is fixed whatever the
+        // thread count.
+        sjtu::list<Item> myList(src.begin(), src.end());
+        myList.sort(sjtu::parallel_policy(t, 1000), ByKey());
+        if (!equal(ans, myList))
+            return false;
+    }
+    sjtu::list<int> ints;
+    for (int i = 0; i < N; ++i) ints.push_front(i);
+    ints.sort(sjtu::parallel_policy(4, 1000));
+    int expect = 0;
+    for (sjtu::list<int>::iterator it = ints.begin(); it != ints.end(); ++it)
+        if (*it != expect++)
+            return false;
+    return expect == N;
+}
+
+bool testListCutoff() {
+    std::vector<Item> src = items(N, N);
+    std::atomic<bool> away(false);
+    sjtu::list<Item> myList(src.begin(), src.end());
+    myList.sort(sjtu::parallel_policy(4, N + 1), Watching{std::this_thread::get_id(), &away});
+    if (away)
+        return false;
+    sjtu::list<Item> other(src.begin(), src.end());
+    other.sort(sjtu::parallel_policy(4, 1000), Watching{std::this_thread::get_id(), &away});
+    std::vector<Item> ans = src;
+    std::stable_sort(ans.begin(), ans.end(), ByKey());
+    return away && equal(ans, myList) && equal(ans, other);
+}
+
+int main() {
+    srand(time(NULL));
+    bool (*testList[])() = {
+            testArrayThreads, testArrayDeterministic, testArrayCutoff, testListThreads, testListCutoff
+    };
+    const char *Messages[] = {
+            "Test 1: Testing parallel array sort() with 1, 2, 3, 8 and all threads...",
+            "Test 2: Testing parallel array sort() gives the same output every run...",
+            "Test 3: Testing parallel array sort() honours serial_cutoff...",
+            "Test 4: Testing parallel list sort() with 1, 2, 3, 8 and all threads...",
+            "Test 5: Testing parallel list sort() honours serial_cutoff..."
+    };
+
+    bool okay = true;
+    for (int i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()) {
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include "class-bint.hpp"
 #include "list.hpp"
 
+#include <atomic>
 #include <iostream>
 #include <list>
 
@@ -185,6 +186,124 @@ bool testSort() {
     return myCounter == ansCounter;
 }
 
+bool testAssign() {
+    std::list<DynamicType> ans;
+    sjtu::list<DynamicType> myList;
+    for (int i = 0; i < N; ++i){
+        ans.push_back(DynamicType(&ansCounter, i));
+        myList.push_back(DynamicType(&myCounter, i));
+    }
+    const DynamicType *first = &myList.front();
+
+    // Same size, then a shorter and a longer source, then a reversed one.
+    const int sizes[] = {N, N / 3, 2 * N, N};
+    for (int k = 0; k < 4; ++k){
+        std::list<DynamicType> ansSrc;
+        sjtu::list<DynamicType> mySrc;
+        for (int i = 0; i < sizes[k]; ++i){
+            int val = rand();
+            ansSrc.push_back(DynamicType(&ansCounter, val));
+            mySrc.push_back(DynamicType(&myCounter, val));
+        }
+        if (k == 3)
+            ansSrc.reverse(), mySrc.reverse();
+        ans = ansSrc, myList = mySrc;
+        if (!equal(ans, myList) || !equal(ansSrc, mySrc) || myCounter != ansCounter)
+            return false;
+        // The surviving front node is reused, not reallocated.
+        if (&myList.front() != first)
+            return false;
+    }
+    return myCounter == ansCounter;
+}
+
+struct ThrowingLess {
+    int budget;
+    bool operator()(const DynamicType &a, const DynamicType &b) {
+        if (--budget < 0) throw 0;
+        return a < b;
+    }
+};
+
+bool testSortThrow() {
+    std::list<DynamicType> ans;
+    sjtu::list<DynamicType> myList;
+    for (int i = 0; i < N; ++i){
+        int val = rand() % 1000;
+        ans.push_back(DynamicType(&ansCounter, val));
+        myList.push_back(DynamicType(&myCounter, val));
+    }
+
+    // Fail at different depths: inside a run scan, a bin merge and the
+    // final combine. The list must stay whole after each failure.
+    const int budgets[] = {0, 1, 7, 100, 5000, N, 10 * N};
+    for (int budget : budgets) {
+        bool thrown = false;
+        try {
+            myList.sort(ThrowingLess{budget});
+        } catch (int) {
+            thrown = true;
+        }
+        if (!thrown || myList.size() != ans.size())
+            return false;
+        int n = 0;
+        for (auto it = myList.begin(); it != myList.end(); ++it) n++;
+        for (auto it = myList.end(); it != myList.begin(); --it) n--;
+        if (n != 0)
+            return false;
+    }
+
+    ans.sort(), myList.sort();
+    if (!equal(ans, myList))
+        return false;
+    return myCounter == ansCounter;
+}
+
+struct SharedThrowingLess {
+    std::atomic<long> *budget;
+    bool operator()(const DynamicType &a, const DynamicType &b) const {
+        if (--*budget < 0) throw 0;
+        return a < b;
+    }
+};
+
+bool testParallelSortThrow() {
+    std::list<DynamicType> ans;
+    sjtu::list<DynamicType> myList;
+    for (int i = 0; i < N; ++i){
+        int val = rand() % 1000;
+        ans.push_back(DynamicType(&ansCounter, val));
+        myList.push_back(DynamicType(&myCounter, val));
+    }
+
+    // The budget is shared by every task, so the later budgets run out
+    // during the merge rounds rather than the per-thread sorts. Each attempt
+    // starts from the unsorted input so the budgets mean the same thing.
+    const long budgets[] = {0, 1000, 300000, 700000, 740000, 760000};
+    for (long budget : budgets) {
+        sjtu::list<DynamicType> copy(myList);
+        std::atomic<long> left(budget);
+        bool thrown = false;
+        try {
+            copy.sort(sjtu::parallel_policy(4, 0), SharedThrowingLess{&left});
+        } catch (int) {
+            thrown = true;
+        }
+        if (!thrown || copy.size() != ans.size())
+            return false;
+        int n = 0;
+        for (auto it = copy.begin(); it != copy.end(); ++it) n++;
+        for (auto it = copy.end(); it != copy.begin(); --it) n--;
+        if (n != 0)
+            return false;
+    }
+
+    ans.sort(), myList.sort(sjtu::parallel_policy(4, 0));
+    if (!equal(ans, myList))
+        return false;
+    return myCounter == ansCounter;
+}
+
 bool testMerge() {
     std::list<DynamicType> ans1, ans2;
     sjtu::list<DynamicType> myList1, myList2;
@@ -238,7 +357,7 @@ bool testUnique() {
 int main(){
     srand(time(NULL));
     bool (*testList[])() = {
-        testPush, testPop, testInsert, testErase, testSort, testMerge, testReverse, testUnique
+        testPush, testPop, testInsert, testErase, testSort, testMerge, testReverse, testUnique, testSortThrow, testParallelSortThrow, testAssign
     };
     const char* Messages[] = {
         "Test 1: Testing push_front() & push_back() and check number of live objects...",
@@ -248,7 +367,10 @@ int main(){
         "Test 5: Testing sort() and check number of live objects...",
         "Test 6: Testing merge() and check number of live objects...",
         "Test 7: Testing reverses() and check number of live objects...",
-        "Test 8: Testing unique() and check number of live objects..."
+        "Test 8: Testing unique() and check number of live objects...",
+        "Test 9: Testing sort() with a throwing comparator and check number of live objects...",
+        "Test 10: Testing parallel sort() with a throwing comparator and check number of live objects...",
+        "Test 11: Testing operator= and check number of live objects..."
     };
 
     bool okay = true;
@@ -0,0 +1,180 @@
+#ifndef SJTU_EPOCH_HPP
+#define SJTU_EPOCH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace sjtu {
+
+/*
+ * Epoch-based memory reclamation. Readers pin the current epoch with an
+ * epoch_guard for as long as they hold pointers into a shared structure;
+ * writers hand unlinked objects to retire() instead of freeing them. An
+ * object retired in epoch e is freed when the global epoch moves past e + 2,
+ * by which point every guard that could have seen it has been dropped.
+ */
+class epoch_domain {
+    friend class epoch_guard;
+private:
+    // Per-guard slot. epoch holds (e << 1) | 1 while pinned in e, 0 otherwise.
+    struct record {
+        std::atomic<uint64_t> epoch;
+        std::atomic<bool> in_use;
+        record *next;
+
+        record() : epoch(0), in_use(true), next(nullptr) {}
+    };
+
+    struct retired {
+        retired *next;
+        void *ptr;
+        void (*deleter)(void *);
+    };
+
+    static constexpr size_t advance_interval = 64;
+
+    std::atomic<uint64_t> global;
+    std::atomic<record *> records;
+    std::atomic<retired *> limbo[3];
+    std::atomic<size_t> pending;
+    std::mutex advance_lock;
+
+    record *acquire() {
+        for (record *r = records.load(); r != nullptr; r = r->next) {
+            bool expected = false;
+            if (!r->in_use.load(std::memory_order_relaxed) && r->in_use.compare_exchange_strong(expected, true)) {
+                return r;
+            }
+        }
+        record *r = new record;
+        record *head = records.load();
+        do {
+            r->next = head;
+        } while (!records.compare_exchange_weak(head, r));
+        return r;
+    }
+
+    // Publishes r as pinned in the current epoch. The recheck makes sure no
+    // advance slipped in between reading the epoch and announcing it.
+    uint64_t pin(record *r) {
+        uint64_t e = global.load();
+        while (true) {
+            r->epoch.store((e << 1) | 1);
+            uint64_t now = global.load();
+            if (now == e) return e;
+            e = now;
+        }
+    }
+
+    void unpin(record *r) {
+        r->epoch.store(0);
+        r->in_use.store(false, std::memory_order_release);
+    }
+
+    static void free_all(retired *r) {
+        while (r != nullptr) {
+            retired *next = r->next;
+            r->deleter(r->ptr);
+            delete r;
+            r = next;
+        }
+    }
+
+    // Defers deleter(p) until no guard pinned now can still reach p. epoch
+    // is the retiring guard's, and p must already be unlinked.
+    void retire(void *p, void (*deleter)(void *), uint64_t epoch) {
+        retired *r = new retired;
+        r->ptr = p;
+        r->deleter = deleter;
+        std::atomic<retired *> &bin = limbo[epoch % 3];
+        r->next = bin.load();
+        while (!bin.compare_exchange_weak(r->next, r)) {}
+        if (pending.fetch_add(1) % advance_interval == advance_interval - 1) {
+            try_advance();
+        }
+    }
+
+public:
+    epoch_domain() : global(2), records(nullptr), pending(0) {
+        for (size_t i = 0; i < 3; i++) limbo[i].store(nullptr);
+    }
+
+    epoch_domain(const epoch_domain &) = delete;
+    epoch_domain &operator=(const epoch_domain &) = delete;
+
+    // No guard may be alive any more.
+    ~epoch_domain() {
+        for (size_t i = 0; i < 3; i++) free_all(limbo[i].exchange(nullptr));
+        record *r = records.load();
+        while (r != nullptr) {
+            record *next = r->next;
+            delete r;
+            r = next;
+        }
+    }
+
+    // Moves the global epoch on if every pinned guard has caught up with it,
+    // freeing what was retired two epochs before the current one. Never
+    // blocks: if another thread is already advancing, this returns at once.
+    bool try_advance() {
+        std::unique_lock<std::mutex> lock(advance_lock, std::try_to_lock);
+        if (!lock.owns_lock()) return false;
+        uint64_t e = global.load();
+        for (record *r = records.load(); r != nullptr; r = r->next) {
+            uint64_t local = r->epoch.load();
+            if (local != 0 && local != ((e << 1) | 1)) return false;
+        }
+        // Guards are all in e, so nobody retires into e + 1's bin (shared
+        // with e - 2) until the epoch moves.
+        free_all(limbo[(e + 1) % 3].exchange(nullptr));
+        global.store(e + 1);
+        return true;
+    }
+
+    // Frees whatever can be freed by advancing repeatedly; for quiescent
+    // points such as shutdown or tests.
+    void synchronize() {
+        for (size_t i = 0; i < 3; i++) {
+            if (!try_advance()) return;
+        }
+    }
+
+    uint64_t epoch() const {
+        return global.load();
+    }
+};
+
+// Pins the domain's current epoch for the guard's lifetime.
+class epoch_guard {
+private:
+    epoch_domain *domain;
+    epoch_domain::record *rec;
+    uint64_t pinned;
+
+public:
+    explicit epoch_guard(epoch_domain &d) : domain(&d), rec(d.acquire()) {
+        pinned = domain->pin(rec);
+    }
+
+    epoch_guard(const epoch_guard &) = delete;
+    epoch_guard &operator=(const epoch_guard &) = delete;
+
+    ~epoch_guard() {
+        domain->unpin(rec);
+    }
+
+    template<typename U>
+    void retire(U *p) {
+        domain->retire(p, [](void *q) { delete static_cast<U *>(q); }, pinned);
+    }
+
+    void retire(void *p, void (*deleter)(void *)) {
+        domain->retire(p, deleter, pinned);
+    }
+};
+
+}
+
+#endif //SJTU_EPOCH_HPP
@@ -0,0 +1,695 @@
+#ifndef SJTU_INDEX_LIST_HPP
+#define SJTU_INDEX_LIST_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+/*
+ * Doubly-linked list stored as parallel arrays: values live in one
+ * contiguous slot array and links are 32-bit slot indices, so an element
+ * costs sizeof(T) + 12 bytes with no per-node allocation. Slot 0 is the
+ * sentinel. Freed slots are recycled, and each slot carries a generation
+ * counter (odd while occupied) that iterators capture, so a stale
+ * iterator is detected instead of silently aliasing a reused slot.
+ * Iterators stay valid across growth since they hold indices, not
+ * addresses. merge() moves the other list's elements into this list's
+ * slots, as the two lists do not share storage.
+ */
+template<typename T>
+class index_list {
+protected:
+    typedef uint32_t index_t;
+
+    T *vals;
+    index_t *nxt;
+    index_t *prv;
+    index_t *gen;
+    index_t cap;
+    index_t used;
+    index_t free_head;
+    size_t count;
+
+    void allocate_arrays(index_t n) {
+        vals = static_cast<T *>(::operator new(sizeof(T) * (size_t)n));
+        nxt = new index_t[n];
+        prv = new index_t[n];
+        gen = new index_t[n];
+        cap = n;
+    }
+
+    void free_arrays() {
+        ::operator delete(vals);
+        delete[] nxt;
+        delete[] prv;
+        delete[] gen;
+    }
+
+    bool occupied(index_t i) const {
+        return gen[i] & 1;
+    }
+
+    // Doubles the arrays. construct(new_vals) runs once the new storage
+    // exists but before anything leaves the old one, so it may build a value
+    // from a reference into the list; if it throws nothing has changed.
+    template<typename Construct>
+    void grow(Construct construct) {
+        if (cap == UINT32_MAX) {
+            throw runtime_error();
+        }
+        index_t n = cap > UINT32_MAX / 2 ? UINT32_MAX : cap * 2;
+        T *new_vals = static_cast<T *>(::operator new(sizeof(T) * (size_t)n));
+        index_t *new_nxt = nullptr, *new_prv = nullptr, *new_gen = nullptr;
+        try {
+            new_nxt = new index_t[n];
+            new_prv = new index_t[n];
+            new_gen = new index_t[n];
+            construct(new_vals);
+        } catch (...) {
+            delete[] new_nxt;
+            delete[] new_prv;
+            delete[] new_gen;
+            ::operator delete(new_vals);
+            throw;
+        }
+        for (index_t i = 1; i < used; i++) {
+            if (gen[i] & 1) {
+                new (new_vals + i) T(std::move(vals[i]));
+                vals[i].~T();
+            }
+        }
+        memcpy(new_nxt, nxt, sizeof(index_t) * used);
+        memcpy(new_prv, prv, sizeof(index_t) * used);
+        memcpy(new_gen, gen, sizeof(index_t) * cap);
+        memset(new_gen + cap, 0, sizeof(index_t) * (n - cap));
+        free_arrays();
+        vals = new_vals;
+        nxt = new_nxt;
+        prv = new_prv;
+        gen = new_gen;
+        cap = n;
+    }
+
+    void grow() {
+        grow([](T *) {});
+    }
+
+    template<typename... Args>
+    index_t acquire(Args &&... args) {
+        index_t i;
+        if (free_head != 0) {
+            i = free_head;
+            free_head = nxt[i];
+        } else if (used == cap) {
+            // args may refer to an element of this list, so the value is
+            // built in the new storage before the old one is freed.
+            i = used;
+            grow([&](T *fresh) { new (fresh + i) T(std::forward<Args>(args)...); });
+            used++;
+            gen[i]++;
+            return i;
+        } else {
+            i = used++;
+        }
+        try {
+            new (vals + i) T(std::forward<Args>(args)...);
+        } catch (...) {
+            nxt[i] = free_head;
+            free_head = i;
+            throw;
+        }
+        gen[i]++;
+        return i;
+    }
+
+    void release(index_t i) {
+        vals[i].~T();
+        gen[i]++;
+        nxt[i] = free_head;
+        free_head = i;
+    }
+
+    void link(index_t pos, index_t i) {
+        prv[i] = prv[pos];
+        nxt[i] = pos;
+        nxt[prv[pos]] = i;
+        prv[pos] = i;
+        count++;
+    }
+
+    void unlink(index_t i) {
+        nxt[prv[i]] = nxt[i];
+        prv[nxt[i]] = prv[i];
+        count--;
+    }
+
+    // Stable merge of two chains linked through nxt and terminated by 0,
+    // left in a. If cmp throws, a still holds every element of both.
+    template<typename Compare>
+    void merge_chains(index_t &a, index_t b, Compare &cmp) {
+        index_t first = 0, last = 0;
+        index_t x = a;
+        try {
+            while (x != 0 && b != 0) {
+                index_t take;
+                if (cmp(vals[b], vals[x])) {
+                    take = b;
+                    b = nxt[b];
+                } else {
+                    take = x;
+                    x = nxt[x];
+                }
+                if (last == 0) first = take;
+                else nxt[last] = take;
+                last = take;
+            }
+        } catch (...) {
+            if (last != 0) nxt[last] = 0;
+            index_t parts[3] = {first, x, b};
+            a = join_chains(parts, 3);
+            throw;
+        }
+        index_t rest = x ? x : b;
+        if (last == 0) {
+            a = rest;
+            return;
+        }
+        nxt[last] = rest;
+        a = first;
+    }
+
+    // Concatenates n chains terminated by 0 (any of which may be empty).
+    index_t join_chains(const index_t *parts, size_t n) {
+        index_t first = 0, last = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (parts[i] == 0) continue;
+            if (last == 0) first = parts[i];
+            else nxt[last] = parts[i];
+            last = parts[i];
+            while (nxt[last] != 0) last = nxt[last];
+        }
+        return first;
+    }
+
+    // Closes a chain of all the elements back into the ring through slot 0,
+    // restoring the prv links.
+    void relink(index_t first) {
+        index_t prev = 0;
+        for (index_t cur = first; cur != 0; cur = nxt[cur]) {
+            nxt[prev] = cur;
+            prv[cur] = prev;
+            prev = cur;
+        }
+        nxt[prev] = 0;
+        prv[0] = prev;
+    }
+
+public:
+    class const_iterator;
+    class iterator {
+    friend class index_list;
+    friend class const_iterator;
+    private:
+        const index_list *container;
+        index_t idx;
+        index_t tag;
+
+        bool stale() const {
+            return container == nullptr || container->gen[idx] != tag;
+        }
+
+    public:
+        iterator() : container(nullptr), idx(0), tag(0) {}
+        iterator(const index_list *c, index_t i) : container(c), idx(i), tag(c->gen[i]) {}
+
+        iterator operator++(int) {
+            iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        iterator & operator++() {
+            if (stale() || idx == 0) {
+                throw invalid_iterator();
+            }
+            idx = container->nxt[idx];
+            tag = container->gen[idx];
+            return *this;
+        }
+
+        iterator operator--(int) {
+            iterator temp = *this;
+            --*this;
+            return temp;
+        }
+
+        iterator & operator--() {
+            if (stale() || idx == container->nxt[0]) {
+                throw invalid_iterator();
+            }
+            idx = container->prv[idx];
+            tag = container->gen[idx];
+            return *this;
+        }
+
+        T & operator *() const {
+            if (stale() || idx == 0) {
+                throw invalid_iterator();
+            }
+            return container->vals[idx];
+        }
+
+        T * operator ->() const {
+            return &**this;
+        }
+
+        bool operator==(const iterator &rhs) const {
+            return container == rhs.container && idx == rhs.idx;
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return container == rhs.container && idx == rhs.idx;
+        }
+
+        bool operator!=(const iterator &rhs) const {
+            return !(*this == rhs);
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
+    class const_iterator {
+    friend class index_list;
+    friend class iterator;
+    private:
+        const index_list *container;
+        index_t idx;
+        index_t tag;
+
+        bool stale() const {
+            return container == nullptr || container->gen[idx] != tag;
+        }
+
+    public:
+        const_iterator() : container(nullptr), idx(0), tag(0) {}
+        const_iterator(const index_list *c, index_t i) : container(c), idx(i), tag(c->gen[i]) {}
+        const_iterator(const iterator &it) : container(it.container), idx(it.idx), tag(it.tag) {}
+
+        const_iterator operator++(int) {
+            const_iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        const_iterator & operator++() {
+            if (stale() || idx == 0) {
+                throw invalid_iterator();
+            }
+            idx = container->nxt[idx];
+            tag = container->gen[idx];
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator temp = *this;
+            --*this;
+            return temp;
+        }
+
+        const_iterator & operator--() {
+            if (stale() || idx == container->nxt[0]) {
+                throw invalid_iterator();
+            }
+            idx = container->prv[idx];
+            tag = container->gen[idx];
+            return *this;
+        }
+
+        const T & operator *() const {
+            if (stale() || idx == 0) {
+                throw invalid_iterator();
+            }
+            return container->vals[idx];
+        }
+
+        const T * operator ->() const {
+            return &**this;
+        }
+
+        bool operator==(const iterator &rhs) const {
+            return container == rhs.container && idx == rhs.idx;
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return container == rhs.container && idx == rhs.idx;
+        }
+
+        bool operator!=(const iterator &rhs) const {
+            return !(*this == rhs);
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
+    index_list() {
+        allocate_arrays(16);
+        nxt[0] = prv[0] = 0;
+        memset(gen, 0, sizeof(index_t) * cap);
+        used = 1;
+        free_head = 0;
+        count = 0;
+    }
+
+    index_list(const index_list &other) {
+        allocate_arrays(other.cap);
+        used = 1;
+        try {
+            for (; used < other.used; used++) {
+                if (other.occupied(used)) new (vals + used) T(other.vals[used]);
+            }
+        } catch (...) {
+            for (index_t i = 1; i < used; i++) {
+                if (other.occupied(i)) vals[i].~T();
+            }
+            free_arrays();
+            throw;
+        }
+        memcpy(nxt, other.nxt, sizeof(index_t) * used);
+        memcpy(prv, other.prv, sizeof(index_t) * used);
+        memcpy(gen, other.gen, sizeof(index_t) * cap);
+        free_head = other.free_head;
+        count = other.count;
+    }
+
+    index_list(index_list &&other) : index_list() {
+        swap(other);
+    }
+
+    ~index_list() {
+        clear();
+        free_arrays();
+    }
+
+    index_list &operator=(const index_list &other) {
+        if (this == &other) {
+            return *this;
+        }
+        index_list temp(other);
+        swap(temp);
+        return *this;
+    }
+
+    index_list &operator=(index_list &&other) {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        swap(other);
+        return *this;
+    }
+
+    void swap(index_list &other) {
+        std::swap(vals, other.vals);
+        std::swap(nxt, other.nxt);
+        std::swap(prv, other.prv);
+        std::swap(gen, other.gen);
+        std::swap(cap, other.cap);
+        std::swap(used, other.used);
+        std::swap(free_head, other.free_head);
+        std::swap(count, other.count);
+    }
+
+    void reserve(size_t n) {
+        while ((size_t)cap - 1 < n) grow();
+    }
+
+    const T & front() const {
+        if (count == 0) {
+            throw container_is_empty();
+        }
+        return vals[nxt[0]];
+    }
+
+    const T & back() const {
+        if (count == 0) {
+            throw container_is_empty();
+        }
+        return vals[prv[0]];
+    }
+
+    iterator begin() {
+        return iterator(this, nxt[0]);
+    }
+
+    const_iterator cbegin() const {
+        return const_iterator(this, nxt[0]);
+    }
+
+    iterator end() {
+        return iterator(this, 0);
+    }
+
+    const_iterator cend() const {
+        return const_iterator(this, 0);
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    void clear() {
+        for (index_t i = nxt[0]; i != 0; i = nxt[i]) {
+            vals[i].~T();
+            gen[i]++;
+        }
+        nxt[0] = prv[0] = 0;
+        used = 1;
+        free_head = 0;
+        count = 0;
+    }
+
+    template<typename... Args>
+    iterator emplace(iterator pos, Args &&... args) {
+        if (pos.container != this || pos.stale()) {
+            throw invalid_iterator();
+        }
+        index_t i = acquire(std::forward<Args>(args)...);
+        link(pos.idx, i);
+        return iterator(this, i);
+    }
+
+    iterator insert(iterator pos, const T &value) {
+        return emplace(pos, value);
+    }
+
+    iterator insert(iterator pos, T &&value) {
+        return emplace(pos, std::move(value));
+    }
+
+    iterator erase(iterator pos) {
+        if (count == 0) {
+            throw container_is_empty();
+        }
+        if (pos.container != this || pos.stale() || pos.idx == 0) {
+            throw invalid_iterator();
+        }
+        index_t next = nxt[pos.idx];
+        unlink(pos.idx);
+        release(pos.idx);
+        return iterator(this, next);
+    }
+
+    void push_back(const T &value) {
+        link(0, acquire(value));
+    }
+
+    void push_back(T &&value) {
+        link(0, acquire(std::move(value)));
+    }
+
+    template<typename... Args>
+    T &emplace_back(Args &&... args) {
+        index_t i = acquire(std::forward<Args>(args)...);
+        link(0, i);
+        return vals[i];
+    }
+
+    void pop_back() {
+        if (count == 0) {
+            throw container_is_empty();
+        }
+        index_t i = prv[0];
+        unlink(i);
+        release(i);
+    }
+
+    void push_front(const T &value) {
+        link(nxt[0], acquire(value));
+    }
+
+    void push_front(T &&value) {
+        link(nxt[0], acquire(std::move(value)));
+    }
+
+    template<typename... Args>
+    T &emplace_front(Args &&... args) {
+        index_t i = acquire(std::forward<Args>(args)...);
+        link(nxt[0], i);
+        return vals[i];
+    }
+
+    void pop_front() {
+        if (count == 0) {
+            throw container_is_empty();
+        }
+        index_t i = nxt[0];
+        unlink(i);
+        release(i);
+    }
+
+    void sort() {
+        sort(std::less<>());
+    }
+
+    // Same natural-run merge sort as list::sort, relinking indices only.
+    // Every element is always in exactly one of cur, run or a bin, so a
+    // throwing cmp leaves them all in the list, in unspecified order.
+    template<typename Compare>
+    void sort(Compare cmp) {
+        if (count <= 1) return;
+
+        index_t bins[64] = {};
+        index_t cur = nxt[0], run = 0;
+        nxt[prv[0]] = 0;
+
+        try {
+            while (cur != 0) {
+                index_t next = nxt[cur];
+                if (next != 0 && cmp(vals[next], vals[cur])) {
+                    run = cur;
+                    nxt[run] = 0;
+                    cur = next;
+                    while (cur != 0 && cmp(vals[cur], vals[run])) {
+                        index_t after = nxt[cur];
+                        nxt[cur] = run;
+                        run = cur;
+                        cur = after;
+                    }
+                } else {
+                    index_t last = cur;
+                    while (next != 0 && !cmp(vals[next], vals[last])) {
+                        last = next;
+                        next = nxt[next];
+                    }
+                    run = cur;
+                    cur = next;
+                    nxt[last] = 0;
+                }
+
+                size_t i = 0;
+                for (; bins[i] != 0; i++) {
+                    index_t b = run;
+                    run = 0;
+                    merge_chains(bins[i], b, cmp);
+                    run = bins[i];
+                    bins[i] = 0;
+                }
+                bins[i] = run;
+                run = 0;
+            }
+
+            for (size_t i = 0; i < 64; i++) {
+                if (bins[i] == 0) continue;
+                if (run != 0) {
+                    index_t b = run;
+                    run = 0;
+                    merge_chains(bins[i], b, cmp);
+                }
+                run = bins[i];
+                bins[i] = 0;
+            }
+        } catch (...) {
+            index_t parts[66];
+            size_t n = 0;
+            parts[n++] = run;
+            for (size_t i = 0; i < 64; i++) parts[n++] = bins[i];
+            parts[n++] = cur;
+            relink(join_chains(parts, n));
+            throw;
+        }
+        relink(run);
+    }
+
+    void merge(index_list &other) {
+        merge(other, std::less<>());
+    }
+
+    template<typename Compare>
+    void merge(index_list &other, Compare cmp) {
+        if (this == &other) return;
+
+        index_t cur = nxt[0];
+        index_t o = other.nxt[0];
+        while (o != 0) {
+            if (cur == 0 || cmp(other.vals[o], vals[cur])) {
+                index_t onext = other.nxt[o];
+                link(cur, acquire(std::move(other.vals[o])));
+                other.unlink(o);
+                other.release(o);
+                o = onext;
+            } else {
+                cur = nxt[cur];
+            }
+        }
+    }
+
+    void reverse() {
+        if (count <= 1) return;
+
+        index_t i = 0;
+        do {
+            index_t temp = nxt[i];
+            nxt[i] = prv[i];
+            prv[i] = temp;
+            i = temp;
+        } while (i != 0);
+    }
+
+    void unique() {
+        unique(std::equal_to<>());
+    }
+
+    template<typename BinaryPredicate>
+    void unique(BinaryPredicate pred) {
+        if (count <= 1) return;
+
+        index_t cur = nxt[0];
+        while (cur != 0 && nxt[cur] != 0) {
+            index_t dup = nxt[cur];
+            if (pred(vals[cur], vals[dup])) {
+                unlink(dup);
+                release(dup);
+            } else {
+                cur = dup;
+            }
+        }
+    }
+};
+
+}
+
+#endif //SJTU_INDEX_LIST_HPP
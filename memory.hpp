@@ -0,0 +1,394 @@
+#ifndef SJTU_MEMORY_HPP
+#define SJTU_MEMORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace sjtu {
+
+/*
+ * Fixed-size block pool. Blocks are carved from power-of-two sized slabs
+ * (aligned to their own size, so the owning slab of a block is found by
+ * masking its address) and recycled through an intrusive free list.
+ */
+class slab_pool {
+private:
+    struct slab {
+        slab *next;
+        size_t live;
+        bool doomed;
+    };
+
+    struct free_block {
+        free_block *next;
+    };
+
+    size_t block_size;
+    size_t header_size;
+    size_t per_slab;
+    size_t slab_bytes;
+    slab *slabs;
+    size_t slab_count;
+    free_block *free_list;
+    char *bump;
+    char *bump_end;
+
+    static size_t round_up(size_t n, size_t align) {
+        return (n + align - 1) / align * align;
+    }
+
+    slab *slab_of(void *p) const {
+        return reinterpret_cast<slab *>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(slab_bytes - 1));
+    }
+
+    void grow() {
+        slab *s = static_cast<slab *>(::operator new(slab_bytes, std::align_val_t(slab_bytes)));
+        s->next = slabs;
+        s->live = 0;
+        s->doomed = false;
+        slabs = s;
+        slab_count++;
+        bump = reinterpret_cast<char *>(s) + header_size;
+        bump_end = bump + per_slab * block_size;
+    }
+
+    void free_slab(slab *s) {
+        ::operator delete(s, std::align_val_t(slab_bytes));
+    }
+
+public:
+    slab_pool(size_t size, size_t align, size_t blocks_per_slab = 1024)
+        : slabs(nullptr), slab_count(0), free_list(nullptr), bump(nullptr), bump_end(nullptr) {
+        if (align < alignof(free_block)) align = alignof(free_block);
+        if (size < sizeof(free_block)) size = sizeof(free_block);
+        if (blocks_per_slab == 0) blocks_per_slab = 1;
+        block_size = round_up(size, align);
+        header_size = round_up(sizeof(slab), align);
+        slab_bytes = 1;
+        while (slab_bytes < header_size + block_size * blocks_per_slab) slab_bytes <<= 1;
+        per_slab = (slab_bytes - header_size) / block_size;
+    }
+
+    slab_pool(const slab_pool &) = delete;
+    slab_pool &operator=(const slab_pool &) = delete;
+
+    ~slab_pool() {
+        release();
+    }
+
+    void *allocate() {
+        if (free_list != nullptr) {
+            free_block *b = free_list;
+            free_list = b->next;
+            slab_of(b)->live++;
+            return b;
+        }
+        if (bump == bump_end) grow();
+        void *p = bump;
+        bump += block_size;
+        slab_of(p)->live++;
+        return p;
+    }
+
+    void deallocate(void *p) {
+        free_block *b = static_cast<free_block *>(p);
+        b->next = free_list;
+        free_list = b;
+        slab_of(p)->live--;
+    }
+
+    // Returns every slab to the system. Only valid once all blocks are dead.
+    void release() {
+        while (slabs != nullptr) {
+            slab *next = slabs->next;
+            free_slab(slabs);
+            slabs = next;
+        }
+        slab_count = 0;
+        free_list = nullptr;
+        bump = bump_end = nullptr;
+    }
+
+    // Frees idle slabs, keeping at most keep_idle of them for reuse.
+    // Returns the number of slabs handed back.
+    size_t shrink(size_t keep_idle = 0) {
+        size_t doomed = 0;
+        for (slab *s = slabs; s != nullptr; s = s->next) {
+            if (s->live != 0) continue;
+            if (keep_idle > 0) {
+                keep_idle--;
+            } else {
+                s->doomed = true;
+                doomed++;
+            }
+        }
+        if (doomed == 0) return 0;
+
+        free_block **link = &free_list;
+        while (*link != nullptr) {
+            if (slab_of(*link)->doomed) *link = (*link)->next;
+            else link = &(*link)->next;
+        }
+        if (bump != nullptr && slab_of(bump - 1)->doomed) {
+            bump = bump_end = nullptr;
+        }
+        slab **s = &slabs;
+        while (*s != nullptr) {
+            if ((*s)->doomed) {
+                slab *dead = *s;
+                *s = dead->next;
+                free_slab(dead);
+                slab_count--;
+            } else {
+                s = &(*s)->next;
+            }
+        }
+        return doomed;
+    }
+
+    size_t blocks_per_slab() const {
+        return per_slab;
+    }
+
+    size_t slabs_held() const {
+        return slab_count;
+    }
+};
+
+/*
+ * Monotonic arena: memory is bumped out of growing chunks and only
+ * returned when the arena is released or destroyed.
+ */
+class arena {
+private:
+    struct chunk {
+        chunk *next;
+        size_t size;
+    };
+
+    chunk *chunks;
+    char *cur;
+    char *end;
+    size_t chunk_size;
+
+public:
+    size_t users;
+
+    arena(size_t chunk_bytes = 64 * 1024) : chunks(nullptr), cur(nullptr), end(nullptr), chunk_size(chunk_bytes), users(0) {}
+
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    ~arena() {
+        release();
+    }
+
+    void *allocate(size_t bytes, size_t align) {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(cur) + align - 1) & ~(uintptr_t)(align - 1);
+        if (cur == nullptr || p + bytes > reinterpret_cast<uintptr_t>(end)) {
+            size_t header = (sizeof(chunk) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+            size_t size = header + bytes + align;
+            if (size < chunk_size) size = chunk_size;
+            chunk *c = static_cast<chunk *>(::operator new(size));
+            c->next = chunks;
+            c->size = size;
+            chunks = c;
+            cur = reinterpret_cast<char *>(c) + header;
+            end = reinterpret_cast<char *>(c) + size;
+            p = (reinterpret_cast<uintptr_t>(cur) + align - 1) & ~(uintptr_t)(align - 1);
+        }
+        cur = reinterpret_cast<char *>(p + bytes);
+        return reinterpret_cast<void *>(p);
+    }
+
+    void release() {
+        while (chunks != nullptr) {
+            chunk *next = chunks->next;
+            ::operator delete(chunks);
+            chunks = next;
+        }
+        cur = end = nullptr;
+    }
+};
+
+/*
+ * Set of slab pools keyed by block size, shared by every pool_allocator
+ * rebound from the same original allocator.
+ */
+class pool_set {
+private:
+    struct entry {
+        entry *next;
+        size_t size;
+        size_t align;
+        slab_pool pool;
+
+        entry(size_t size, size_t align, size_t blocks) : next(nullptr), size(size), align(align), pool(size, align, blocks) {}
+    };
+
+    entry *entries;
+    size_t blocks_per_slab;
+
+public:
+    size_t users;
+
+    pool_set(size_t blocks = 1024) : entries(nullptr), blocks_per_slab(blocks), users(0) {}
+
+    pool_set(const pool_set &) = delete;
+    pool_set &operator=(const pool_set &) = delete;
+
+    ~pool_set() {
+        while (entries != nullptr) {
+            entry *next = entries->next;
+            delete entries;
+            entries = next;
+        }
+    }
+
+    slab_pool *get(size_t size, size_t align) {
+        for (entry *e = entries; e != nullptr; e = e->next) {
+            if (e->size == size && e->align == align) return &e->pool;
+        }
+        entry *e = new entry(size, align, blocks_per_slab);
+        e->next = entries;
+        entries = e;
+        return &e->pool;
+    }
+
+    size_t shrink(size_t keep_idle = 0) {
+        size_t freed = 0;
+        for (entry *e = entries; e != nullptr; e = e->next) {
+            freed += e->pool.shrink(keep_idle);
+        }
+        return freed;
+    }
+};
+
+/*
+ * std-compatible allocator over a shared arena. deallocate() is a no-op;
+ * the memory goes away with the last allocator copy (or arena_release()).
+ */
+template<typename T>
+class arena_allocator {
+    template<typename U> friend class arena_allocator;
+private:
+    arena *res;
+
+public:
+    typedef T value_type;
+
+    explicit arena_allocator(size_t chunk_bytes = 64 * 1024) : res(new arena(chunk_bytes)) {
+        res->users = 1;
+    }
+
+    arena_allocator(const arena_allocator &other) noexcept : res(other.res) {
+        res->users++;
+    }
+
+    template<typename U>
+    arena_allocator(const arena_allocator<U> &other) noexcept : res(other.res) {
+        res->users++;
+    }
+
+    arena_allocator &operator=(const arena_allocator &other) noexcept {
+        other.res->users++;
+        if (--res->users == 0) delete res;
+        res = other.res;
+        return *this;
+    }
+
+    ~arena_allocator() {
+        if (--res->users == 0) delete res;
+    }
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(res->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, size_t) noexcept {}
+
+    // Drops every allocation made through any copy of this allocator at once.
+    void arena_release() {
+        res->release();
+    }
+
+    template<typename U>
+    bool operator==(const arena_allocator<U> &rhs) const noexcept {
+        return res == rhs.res;
+    }
+
+    template<typename U>
+    bool operator!=(const arena_allocator<U> &rhs) const noexcept {
+        return res != rhs.res;
+    }
+};
+
+/*
+ * std-compatible allocator that serves single-object requests from slab
+ * pools shared by all copies; array requests go to the global heap.
+ */
+template<typename T>
+class pool_allocator {
+    template<typename U> friend class pool_allocator;
+private:
+    pool_set *set;
+    slab_pool *pool;
+
+public:
+    typedef T value_type;
+
+    explicit pool_allocator(size_t blocks_per_slab = 1024) : set(new pool_set(blocks_per_slab)) {
+        set->users = 1;
+        pool = set->get(sizeof(T), alignof(T));
+    }
+
+    pool_allocator(const pool_allocator &other) noexcept : set(other.set), pool(other.pool) {
+        set->users++;
+    }
+
+    template<typename U>
+    pool_allocator(const pool_allocator<U> &other) : set(other.set), pool(other.set->get(sizeof(T), alignof(T))) {
+        set->users++;
+    }
+
+    pool_allocator &operator=(const pool_allocator &other) noexcept {
+        other.set->users++;
+        if (--set->users == 0) delete set;
+        set = other.set;
+        pool = other.pool;
+        return *this;
+    }
+
+    ~pool_allocator() {
+        if (--set->users == 0) delete set;
+    }
+
+    T *allocate(size_t n) {
+        if (n == 1) return static_cast<T *>(pool->allocate());
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n) noexcept {
+        if (n == 1) pool->deallocate(p);
+        else ::operator delete(p);
+    }
+
+    size_t shrink(size_t keep_idle = 0) {
+        return set->shrink(keep_idle);
+    }
+
+    template<typename U>
+    bool operator==(const pool_allocator<U> &rhs) const noexcept {
+        return set == rhs.set;
+    }
+
+    template<typename U>
+    bool operator!=(const pool_allocator<U> &rhs) const noexcept {
+        return set != rhs.set;
+    }
+};
+
+}
+
+#endif //SJTU_MEMORY_HPP
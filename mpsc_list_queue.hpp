@@ -0,0 +1,231 @@
+#ifndef SJTU_MPSC_LIST_QUEUE_HPP
+#define SJTU_MPSC_LIST_QUEUE_HPP
+
+#include "exceptions.hpp"
+#include "list.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace sjtu {
+
+/*
+ * Multi-producer, single-consumer FIFO built from list<T, Alloc> nodes
+ * (Vyukov's intrusive queue). push_back links a node with one atomic
+ * exchange on the tail plus one store, so producers never wait on each
+ * other or on the consumer. Only one thread at a time may call pop_front,
+ * drain_into or empty.
+ *
+ * Because the nodes are list nodes, drain_into() hands everything queued
+ * to a list in one link step, without copying values. Nodes the consumer
+ * pops are kept in a small bounded cache that producers take from before
+ * asking Alloc, which must therefore be safe to call from several threads.
+ *
+ * Links between queued nodes are read and written with the GCC/Clang
+ * __atomic builtins, since list's node links are plain pointers.
+ */
+template<typename T, typename Alloc = std::allocator<T>>
+class mpsc_list_queue {
+private:
+    typedef list<T, Alloc> list_type;
+    typedef typename list_type::node_base node_base;
+    typedef typename list_type::node node;
+    typedef typename list_type::node_allocator node_allocator;
+    typedef typename list_type::node_traits node_traits;
+
+    // Bounded cache of spare nodes: the consumer puts, producers take.
+    // Per-cell sequence numbers keep it ABA-free (Vyukov's bounded queue).
+    class cell {
+    public:
+        std::atomic<size_t> seq;
+        node_base *spare;
+    };
+
+    static node_base *load_next(node_base *n) {
+        return __atomic_load_n(&n->next, __ATOMIC_ACQUIRE);
+    }
+
+    static void store_next(node_base *n, node_base *next) {
+        __atomic_store_n(&n->next, next, __ATOMIC_RELEASE);
+    }
+
+    node_allocator alloc;
+    std::atomic<node_base *> tail;
+    node_base *head;
+    node_base stub;
+    cell *cache;
+    size_t cache_mask;
+    size_t put_pos;
+    std::atomic<size_t> take_pos;
+
+    void link(node_base *n) {
+        __atomic_store_n(&n->next, (node_base *)nullptr, __ATOMIC_RELAXED);
+        node_base *prev = tail.exchange(n, std::memory_order_acq_rel);
+        store_next(prev, n);
+    }
+
+    // Takes the oldest node off the queue, or nullptr if it is empty or
+    // the newest push has not finished linking yet.
+    node_base *pop_node() {
+        node_base *h = head;
+        node_base *next = load_next(h);
+        if (h == &stub) {
+            if (next == nullptr) return nullptr;
+            head = next;
+            h = next;
+            next = load_next(next);
+        }
+        if (next != nullptr) {
+            head = next;
+            return h;
+        }
+        if (h != tail.load(std::memory_order_acquire)) return nullptr;
+        link(&stub);
+        next = load_next(h);
+        if (next != nullptr) {
+            head = next;
+            return h;
+        }
+        return nullptr;
+    }
+
+    node_base *take_spare() {
+        if (cache == nullptr) return nullptr;
+        size_t pos = take_pos.load(std::memory_order_relaxed);
+        while (true) {
+            cell &c = cache[pos & cache_mask];
+            size_t seq = c.seq.load(std::memory_order_acquire);
+            long diff = (long)(seq - (pos + 1));
+            if (diff == 0) {
+                if (take_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    node_base *spare = c.spare;
+                    c.seq.store(pos + cache_mask + 1, std::memory_order_release);
+                    return spare;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = take_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool put_spare(node_base *spare) {
+        if (cache == nullptr) return false;
+        cell &c = cache[put_pos & cache_mask];
+        if (c.seq.load(std::memory_order_acquire) != put_pos) return false;
+        c.spare = spare;
+        c.seq.store(put_pos + 1, std::memory_order_release);
+        put_pos++;
+        return true;
+    }
+
+    template<typename... Args>
+    node *create(Args &&... args) {
+        node *p = static_cast<node *>(take_spare());
+        if (p == nullptr) {
+            p = node_traits::allocate(alloc, 1);
+        }
+        try {
+            node_traits::construct(alloc, p, std::forward<Args>(args)...);
+        } catch (...) {
+            node_traits::deallocate(alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    void recycle(node_base *p) {
+        node_traits::destroy(alloc, static_cast<node *>(p));
+        if (!put_spare(p)) {
+            node_traits::deallocate(alloc, static_cast<node *>(p), 1);
+        }
+    }
+
+public:
+    // cache_size spare nodes (rounded up to a power of two) are kept for
+    // reuse; 0 turns recycling off.
+    explicit mpsc_list_queue(size_t cache_size = 1024, const Alloc &a = Alloc())
+        : alloc(a), tail(&stub), head(&stub), stub(nullptr, nullptr),
+          cache(nullptr), cache_mask(0), put_pos(0), take_pos(0) {
+        if (cache_size != 0) {
+            size_t n = 1;
+            while (n < cache_size) n <<= 1;
+            cache = new cell[n];
+            cache_mask = n - 1;
+            for (size_t i = 0; i < n; i++) {
+                cache[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    mpsc_list_queue(const mpsc_list_queue &) = delete;
+    mpsc_list_queue &operator=(const mpsc_list_queue &) = delete;
+
+    // No producer may still be running.
+    ~mpsc_list_queue() {
+        node_base *p;
+        while ((p = pop_node()) != nullptr) {
+            node_traits::destroy(alloc, static_cast<node *>(p));
+            node_traits::deallocate(alloc, static_cast<node *>(p), 1);
+        }
+        while ((p = take_spare()) != nullptr) {
+            node_traits::deallocate(alloc, static_cast<node *>(p), 1);
+        }
+        delete[] cache;
+    }
+
+    void push_back(const T &value) {
+        link(create(value));
+    }
+
+    void push_back(T &&value) {
+        link(create(std::move(value)));
+    }
+
+    template<typename... Args>
+    void emplace_back(Args &&... args) {
+        link(create(std::forward<Args>(args)...));
+    }
+
+    // Consumer only. Moves the oldest element into out; false when nothing
+    // is ready, which includes a push that has swapped the tail but not
+    // yet linked its node.
+    bool pop_front(T &out) {
+        node_base *p = pop_node();
+        if (p == nullptr) return false;
+        out = std::move(list_type::value_of(p));
+        recycle(p);
+        return true;
+    }
+
+    // Consumer only. Appends every ready element to dst by relinking the
+    // nodes, and returns how many moved. dst must be an unpooled list whose
+    // allocator compares equal to the queue's.
+    size_t drain_into(list_type &dst) {
+        if (dst.pool != nullptr || !(dst.alloc == alloc)) {
+            throw runtime_error();
+        }
+        typename list_type::chain c;
+        node_base *p;
+        while ((p = pop_node()) != nullptr) {
+            c.append(p);
+        }
+        size_t n = c.length;
+        dst.link(dst.end_node(), c);
+        return n;
+    }
+
+    // Consumer only.
+    bool empty() const {
+        node_base *h = head;
+        if (h == &stub) h = load_next(h);
+        return h == nullptr;
+    }
+};
+
+}
+
+#endif //SJTU_MPSC_LIST_QUEUE_HPP
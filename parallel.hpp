@@ -0,0 +1,115 @@
+#ifndef SJTU_PARALLEL_HPP
+#define SJTU_PARALLEL_HPP
+
+#include "algorithm.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace sjtu{
+
+namespace detail{
+
+// Runs fn(0) .. fn(n - 1) concurrently, fn(0) on the calling thread, and
+// rethrows the first exception raised once every call has returned. A task
+// whose thread cannot be started runs inline instead.
+template<typename Function>
+void parallel_for(size_t n, Function fn){
+    std::exception_ptr error;
+    std::mutex error_lock;
+    auto task = [&](size_t i){
+        try{
+            fn(i);
+        } catch (...){
+            std::lock_guard<std::mutex> guard(error_lock);
+            if (!error) error = std::current_exception();
+        }
+    };
+    std::unique_ptr<std::thread[]> workers(new std::thread[n]);
+    for (size_t i = 1; i < n; i++){
+        try{
+            workers[i] = std::thread(task, i);
+        } catch (...){
+            task(i);
+        }
+    }
+    task(0);
+    for (size_t i = 1; i < n; i++){
+        if (workers[i].joinable()) workers[i].join();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+// Fork/join introsort: each partition hands one side to a new thread and
+// splits the thread budget between the two sides in proportion to their
+// sizes, so no more than threads run at once. Ranges shorter than cutoff,
+// or left with a budget of one thread, finish serially. Partitioning does
+// not depend on timing, so the output is the same on every run.
+template<typename RandomIt, typename Compare>
+void parallel_introsort(RandomIt begin, RandomIt end, int depth, size_t threads, long cutoff, Compare &cmp){
+    while (threads > 1 && depth > 0 && end - begin > cutoff){
+        depth--;
+        RandomIt lt, gt;
+        partition3(begin, end, lt, gt, cmp);
+        long left = lt - begin, right = end - gt;
+        if (left == 0 || right == 0){
+            if (left == 0) begin = gt;
+            else end = lt;
+            continue;
+        }
+        size_t left_threads = (size_t)((double)threads * left / (left + right) + 0.5);
+        if (left_threads < 1) left_threads = 1;
+        if (left_threads > threads - 1) left_threads = threads - 1;
+        size_t right_threads = threads - left_threads;
+        parallel_for(2, [&](size_t i){
+            Compare c(cmp);
+            if (i == 0) parallel_introsort(begin, lt, depth, left_threads, cutoff, c);
+            else parallel_introsort(gt, end, depth, right_threads, cutoff, c);
+        });
+        return ;
+    }
+    introsort_loop(begin, end, depth, cmp);
+    insertion_sort(begin, end, cmp);
+}
+
+}
+
+// Execution policy for the parallel sorts. threads == 0 means one per
+// hardware thread; inputs shorter than serial_cutoff are sorted on the
+// calling thread alone.
+struct parallel_policy{
+    size_t threads;
+    size_t serial_cutoff;
+
+    explicit parallel_policy(size_t threads = 0, size_t serial_cutoff = 1 << 16)
+        : threads(threads), serial_cutoff(serial_cutoff){}
+
+    size_t concurrency() const{
+        if (threads != 0) return threads;
+        size_t n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+};
+
+// Parallel sort of a random-access range under policy; see
+// detail::parallel_introsort. cmp is copied into every task.
+template<typename RandomIt, typename Compare>
+void sort(const parallel_policy &policy, RandomIt begin, RandomIt end, Compare cmp){
+    long len = end - begin;
+    if (len <= 1) return ;
+    long cutoff = (long)policy.serial_cutoff;
+    if (cutoff < detail::insertion_cutoff) cutoff = detail::insertion_cutoff;
+    detail::parallel_introsort(begin, end, detail::depth_limit(len), policy.concurrency(), cutoff, cmp);
+}
+
+template<typename RandomIt>
+void sort(const parallel_policy &policy, RandomIt begin, RandomIt end){
+    sort(policy, begin, end, std::less<>());
+}
+
+};
+
+#endif //SJTU_PARALLEL_HPP
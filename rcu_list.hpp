@@ -0,0 +1,279 @@
+#ifndef SJTU_RCU_LIST_HPP
+#define SJTU_RCU_LIST_HPP
+
+#include "epoch.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace sjtu {
+
+/*
+ * Read-mostly list in the RCU style. Readers open a view with read(),
+ * which claims an epoch record (one compare-and-swap, or an allocation
+ * when every record is busy) and stores the pinned epoch in it; closing
+ * the view clears it. Apart from that record of its own, a reader only
+ * walks next links with acquire loads and takes no lock, so readers never
+ * wait for writers and never block them. Writers serialize on one mutex,
+ * publish each change with a single release store, and retire the nodes
+ * they unlink through an epoch_domain, so a node is only freed after
+ * every view that might still be standing on it has closed.
+ *
+ * A view sees every element that stays in the list while it is open and
+ * any subset of those added or removed concurrently, always in list order.
+ * Elements are never modified in place; replace one by removing it and
+ * inserting the new value.
+ */
+template<typename T>
+class rcu_list {
+private:
+    class node_base {
+    public:
+        std::atomic<node_base *> next;
+        node_base *prev;
+
+        node_base() : next(nullptr), prev(nullptr) {}
+    };
+
+    class node : public node_base {
+    public:
+        T value;
+
+        template<typename... Args>
+        explicit node(Args &&... args) : value(std::forward<Args>(args)...) {}
+    };
+
+    node_base head;
+    node_base *tail;
+    std::atomic<size_t> count;
+    std::mutex write_lock;
+    mutable epoch_domain domain;
+
+    // Called with write_lock held.
+    void link_after(node_base *pos, node_base *fresh) {
+        node_base *next = pos->next.load(std::memory_order_relaxed);
+        fresh->prev = pos;
+        fresh->next.store(next, std::memory_order_relaxed);
+        if (next != nullptr) next->prev = fresh;
+        else tail = fresh;
+        pos->next.store(fresh, std::memory_order_release);
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Called with write_lock held. pos keeps its next link so views that
+    // are standing on it can still move on.
+    void unlink(node_base *pos, epoch_guard &guard) {
+        node_base *next = pos->next.load(std::memory_order_relaxed);
+        pos->prev->next.store(next, std::memory_order_release);
+        if (next != nullptr) next->prev = pos->prev;
+        else tail = pos->prev;
+        count.fetch_sub(1, std::memory_order_relaxed);
+        guard.retire(static_cast<node *>(pos));
+    }
+
+public:
+    class const_iterator {
+    friend class rcu_list;
+    private:
+        const node_base *ptr;
+
+        explicit const_iterator(const node_base *p) : ptr(p) {}
+
+    public:
+        const_iterator() : ptr(nullptr) {}
+
+        const T & operator*() const {
+            return static_cast<const node *>(ptr)->value;
+        }
+
+        const T * operator->() const {
+            return &static_cast<const node *>(ptr)->value;
+        }
+
+        const_iterator &operator++() {
+            ptr = ptr->next.load(std::memory_order_acquire);
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return ptr == rhs.ptr;
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return ptr != rhs.ptr;
+        }
+    };
+
+    // A read-side critical section. Iterators taken from a view stay
+    // valid until the view is destroyed, whatever writers do meanwhile.
+    class view {
+    friend class rcu_list;
+    private:
+        epoch_guard guard;
+        const node_base *first;
+
+        // guard is declared first, so the epoch is pinned before head is read.
+        view(epoch_domain &d, const node_base &head) : guard(d), first(head.next.load(std::memory_order_acquire)) {}
+
+    public:
+        const_iterator begin() const {
+            return const_iterator(first);
+        }
+
+        const_iterator end() const {
+            return const_iterator(nullptr);
+        }
+    };
+
+    rcu_list() : tail(&head), count(0) {}
+
+    rcu_list(const rcu_list &) = delete;
+    rcu_list &operator=(const rcu_list &) = delete;
+
+    // No view may still be open.
+    ~rcu_list() {
+        node_base *cur = head.next.load(std::memory_order_relaxed);
+        while (cur != nullptr) {
+            node_base *next = cur->next.load(std::memory_order_relaxed);
+            delete static_cast<node *>(cur);
+            cur = next;
+        }
+    }
+
+    view read() const {
+        return view(domain, head);
+    }
+
+    template<typename Function>
+    void for_each(Function fn) const {
+        view v = read();
+        for (const_iterator it = v.begin(); it != v.end(); ++it) {
+            fn(*it);
+        }
+    }
+
+    void push_back(const T &value) {
+        node *fresh = new node(value);
+        std::lock_guard<std::mutex> lock(write_lock);
+        link_after(tail, fresh);
+    }
+
+    void push_front(const T &value) {
+        node *fresh = new node(value);
+        std::lock_guard<std::mutex> lock(write_lock);
+        link_after(&head, fresh);
+    }
+
+    // Inserts value before the first element for which pred is true, or at
+    // the back if there is none.
+    template<typename Predicate>
+    void insert_before_if(const T &value, Predicate pred) {
+        node *fresh = new node(value);
+        std::lock_guard<std::mutex> lock(write_lock);
+        node_base *pos = &head;
+        for (node_base *cur = head.next.load(std::memory_order_relaxed); cur != nullptr;
+             cur = cur->next.load(std::memory_order_relaxed)) {
+            if (pred(static_cast<node *>(cur)->value)) break;
+            pos = cur;
+        }
+        link_after(pos, fresh);
+    }
+
+    // Removes every element equal to value; returns how many went.
+    size_t remove(const T &value) {
+        return remove_if([&value](const T &v) { return v == value; });
+    }
+
+    template<typename Predicate>
+    size_t remove_if(Predicate pred) {
+        std::lock_guard<std::mutex> lock(write_lock);
+        epoch_guard guard(domain);
+        size_t removed = 0;
+        node_base *cur = head.next.load(std::memory_order_relaxed);
+        while (cur != nullptr) {
+            node_base *next = cur->next.load(std::memory_order_relaxed);
+            if (pred(static_cast<node *>(cur)->value)) {
+                unlink(cur, guard);
+                removed++;
+            }
+            cur = next;
+        }
+        return removed;
+    }
+
+    // Replaces the whole contents with [first, last). The new chain is built
+    // off to the side and published with one store; readers see either the
+    // old contents or the new, never a mix.
+    template<typename InputIt>
+    void assign(InputIt first, InputIt last) {
+        node_base fresh;
+        node_base *back = &fresh;
+        size_t n = 0;
+        try {
+            for (; first != last; ++first) {
+                node *p = new node(*first);
+                p->prev = back;
+                back->next.store(p, std::memory_order_relaxed);
+                back = p;
+                n++;
+            }
+        } catch (...) {
+            node_base *cur = fresh.next.load(std::memory_order_relaxed);
+            while (cur != nullptr) {
+                node_base *next = cur->next.load(std::memory_order_relaxed);
+                delete static_cast<node *>(cur);
+                cur = next;
+            }
+            throw;
+        }
+
+        std::lock_guard<std::mutex> lock(write_lock);
+        epoch_guard guard(domain);
+        node_base *old = head.next.load(std::memory_order_relaxed);
+        node_base *front = fresh.next.load(std::memory_order_relaxed);
+        if (front != nullptr) {
+            front->prev = &head;
+            tail = back;
+        } else {
+            tail = &head;
+        }
+        head.next.store(front, std::memory_order_release);
+        count.store(n, std::memory_order_relaxed);
+        while (old != nullptr) {
+            node_base *next = old->next.load(std::memory_order_relaxed);
+            guard.retire(static_cast<node *>(old));
+            old = next;
+        }
+    }
+
+    void clear() {
+        remove_if([](const T &) { return true; });
+    }
+
+    // Exact once writers are quiet.
+    size_t size() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // Frees retired nodes no reader can reach any more; useful at quiescent
+    // points, since reclamation otherwise trails the writers.
+    void collect() {
+        domain.synchronize();
+    }
+};
+
+}
+
+#endif //SJTU_RCU_LIST_HPP
@@ -0,0 +1,364 @@
+#ifndef SJTU_SKIP_INDEX_HPP
+#define SJTU_SKIP_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace sjtu {
+
+namespace detail {
+
+/*
+ * Skip-list overlay over an existing circular doubly linked chain. The
+ * chain itself is level 0; about a quarter of its nodes are given a tower
+ * of express links (level l skips to the next tower at least l high) that
+ * also record how many level-0 steps they span. Towers live in a side
+ * table keyed by node address, so the chain's nodes need no extra field.
+ *
+ * Positions count from the sentinel: it is 0, the elements are 1..size and
+ * the sentinel is size + 1 again on the way round. Node only needs public
+ * prev and next pointers.
+ */
+template<typename Node>
+class skip_index {
+private:
+    static const int max_level = 32;
+
+    struct tower;
+
+    struct link {
+        tower *next;
+        tower *prev;
+        size_t width;
+    };
+
+    struct tower {
+        Node *node;
+        int height;
+        link links[1];
+    };
+
+    struct slot {
+        Node *key;
+        tower *value;
+    };
+
+    Node *sentinel;
+    tower *head;
+    int top;
+    size_t size;
+    bool dirty;
+    uint64_t seed;
+    slot *table;
+    size_t capacity;
+    size_t used;
+    int shift;
+
+    static tower *make_tower(Node *n, int height) {
+        tower *t = static_cast<tower *>(::operator new(sizeof(tower) + (height - 1) * sizeof(link)));
+        t->node = n;
+        t->height = height;
+        for (int i = 0; i < height; i++) {
+            t->links[i].next = t->links[i].prev = nullptr;
+            t->links[i].width = 0;
+        }
+        return t;
+    }
+
+    static void free_tower(tower *t) {
+        ::operator delete(t);
+    }
+
+    // Height 0 (no tower) with probability 3/4, then one more level per 1/4.
+    int random_height() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        uint64_t bits = seed;
+        int h = 0;
+        while ((bits & 3) == 0 && h < max_level - 1) {
+            h++;
+            bits >>= 2;
+        }
+        return h;
+    }
+
+    size_t hash(Node *key) const {
+        return (size_t)(((uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    tower *find(Node *key) const {
+        for (size_t i = hash(key);; i = (i + 1) & (capacity - 1)) {
+            if (table[i].key == key) return table[i].value;
+            if (table[i].key == nullptr) return nullptr;
+        }
+    }
+
+    void put(Node *key, tower *value) {
+        if ((used + 1) * 2 > capacity) grow();
+        size_t i = hash(key);
+        while (table[i].key != nullptr) i = (i + 1) & (capacity - 1);
+        table[i].key = key;
+        table[i].value = value;
+        used++;
+    }
+
+    // Linear-probing delete with backward shift, so no tombstones pile up.
+    void remove(Node *key) {
+        size_t i = hash(key);
+        while (table[i].key != key) i = (i + 1) & (capacity - 1);
+        size_t hole = i;
+        for (size_t j = (i + 1) & (capacity - 1); table[j].key != nullptr; j = (j + 1) & (capacity - 1)) {
+            size_t home = hash(table[j].key);
+            if (((j - home) & (capacity - 1)) >= ((j - hole) & (capacity - 1))) {
+                table[hole] = table[j];
+                hole = j;
+            }
+        }
+        table[hole].key = nullptr;
+        used--;
+    }
+
+    // Allocates before touching any member, so if that throws the table is
+    // left as it was.
+    void grow() {
+        size_t new_capacity = capacity ? capacity * 2 : 64;
+        slot *fresh = new slot[new_capacity];
+        for (size_t i = 0; i < new_capacity; i++) fresh[i].key = nullptr;
+        slot *old = table;
+        size_t old_capacity = capacity;
+        table = fresh;
+        capacity = new_capacity;
+        shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) shift--;
+        used = 0;
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old[i].key != nullptr) put(old[i].key, old[i].value);
+        }
+        delete[] old;
+    }
+
+    void drop_towers() {
+        for (size_t i = 0; i < capacity; i++) {
+            if (table[i].key != nullptr && table[i].value != head) free_tower(table[i].value);
+            table[i].key = nullptr;
+        }
+        used = 0;
+        for (int l = 0; l < max_level; l++) {
+            head->links[l].next = head->links[l].prev = nullptr;
+            head->links[l].width = 0;
+        }
+        top = 0;
+    }
+
+    // For levels 1..top, the last tower at least that high strictly before
+    // n (which must be in the chain, or its sentinel) and its distance to n.
+    void locate(Node *n, tower **pred, size_t *dist) const {
+        Node *cur = n->prev;
+        size_t d = 1;
+        tower *t;
+        while ((t = find(cur)) == nullptr) {
+            cur = cur->prev;
+            d++;
+        }
+        for (int l = 1; l <= top; l++) {
+            while (t->height < l) {
+                tower *back = t->links[l - 2].prev;
+                d += back->links[l - 2].width;
+                t = back;
+            }
+            pred[l] = t;
+            dist[l] = d;
+        }
+    }
+
+public:
+    explicit skip_index(Node *s)
+        : sentinel(s), head(make_tower(s, max_level)), top(0), size(0), dirty(true),
+          seed((0x2545F4914F6CDD1Dull ^ (uint64_t)(uintptr_t)this) | 1), table(nullptr), capacity(0), used(0), shift(64) {
+        grow();
+    }
+
+    skip_index(const skip_index &) = delete;
+    skip_index &operator=(const skip_index &) = delete;
+
+    ~skip_index() {
+        drop_towers();
+        free_tower(head);
+        delete[] table;
+    }
+
+    // Bulk relinks mark the overlay stale; it is rebuilt on the next query.
+    void invalidate() {
+        dirty = true;
+    }
+
+    // Whether the next query has to rebuild the overlay first.
+    bool stale() const {
+        return dirty;
+    }
+
+    // The chain now hangs off a different sentinel (the owner was moved).
+    void rebind(Node *s) {
+        sentinel = s;
+        head->node = s;
+        dirty = true;
+    }
+
+    void refresh() {
+        if (!dirty) return;
+        drop_towers();
+        head->node = sentinel;
+        put(sentinel, head);
+        tower *last[max_level + 1];
+        size_t last_pos[max_level + 1];
+        for (int l = 1; l <= max_level; l++) {
+            last[l] = head;
+            last_pos[l] = 0;
+        }
+        size_t pos = 0;
+        for (Node *cur = sentinel->next; cur != sentinel; cur = cur->next) {
+            pos++;
+            int h = random_height();
+            if (h == 0) continue;
+            tower *t = make_tower(cur, h);
+            put(cur, t);
+            for (int l = 1; l <= h; l++) {
+                last[l]->links[l - 1].next = t;
+                last[l]->links[l - 1].width = pos - last_pos[l];
+                t->links[l - 1].prev = last[l];
+                last[l] = t;
+                last_pos[l] = pos;
+            }
+            if (h > top) top = h;
+        }
+        size = pos;
+        for (int l = 1; l <= top; l++) {
+            last[l]->links[l - 1].width = size + 1 - last_pos[l];
+        }
+        dirty = false;
+    }
+
+    // n has just been linked into the chain.
+    void inserted(Node *n) {
+        if (dirty) return;
+        int h = random_height();
+        for (int l = top + 1; l <= h; l++) {
+            head->links[l - 1].next = nullptr;
+            head->links[l - 1].width = size + 1;
+        }
+        tower *t = nullptr;
+        if (h > 0) {
+            // Allocate up front; if that fails the overlay just goes stale.
+            try {
+                t = make_tower(n, h);
+                put(n, t);
+            } catch (...) {
+                if (t != nullptr) free_tower(t);
+                dirty = true;
+                return;
+            }
+        }
+        if (h > top) top = h;
+        tower *pred[max_level + 1];
+        size_t dist[max_level + 1];
+        locate(n, pred, dist);
+        for (int l = 1; l <= top; l++) {
+            link &p = pred[l]->links[l - 1];
+            if (l <= h) {
+                link &mine = t->links[l - 1];
+                mine.next = p.next;
+                mine.prev = pred[l];
+                mine.width = p.width + 1 - dist[l];
+                if (p.next != nullptr) p.next->links[l - 1].prev = t;
+                p.next = t;
+                p.width = dist[l];
+            } else {
+                p.width++;
+            }
+        }
+        size++;
+    }
+
+    // n is about to be unlinked from the chain.
+    void erased(Node *n) {
+        if (dirty) return;
+        tower *t = find(n);
+        tower *pred[max_level + 1];
+        size_t dist[max_level + 1];
+        locate(n, pred, dist);
+        for (int l = 1; l <= top; l++) {
+            link &p = pred[l]->links[l - 1];
+            if (t != nullptr && l <= t->height) {
+                link &mine = t->links[l - 1];
+                p.width += mine.width - 1;
+                p.next = mine.next;
+                if (mine.next != nullptr) mine.next->links[l - 1].prev = pred[l];
+            } else {
+                p.width--;
+            }
+        }
+        if (t != nullptr) {
+            remove(n);
+            free_tower(t);
+        }
+        while (top > 0 && head->links[top - 1].next == nullptr) top--;
+        size--;
+    }
+
+    // The element at 0-based index k; k must be below the chain's length.
+    Node *nth(size_t k) {
+        refresh();
+        size_t target = k + 1, pos = 0;
+        tower *t = head;
+        for (int l = top; l >= 1; l--) {
+            while (t->links[l - 1].next != nullptr && pos + t->links[l - 1].width <= target) {
+                pos += t->links[l - 1].width;
+                t = t->links[l - 1].next;
+            }
+        }
+        Node *cur = t->node;
+        for (; pos < target; pos++) cur = cur->next;
+        return cur;
+    }
+
+    // 0-based index of an element of the chain.
+    size_t index_of(Node *n) {
+        refresh();
+        size_t pos = 0;
+        tower *t;
+        while ((t = find(n)) == nullptr) {
+            n = n->prev;
+            pos++;
+        }
+        while (t != head) {
+            link &up = t->links[t->height - 1];
+            pos += up.prev->links[t->height - 1].width;
+            t = up.prev;
+        }
+        return pos - 1;
+    }
+
+    // First element for which before(element) is false, or the sentinel.
+    // The chain must be partitioned by before: trues first, then falses.
+    template<typename Predicate>
+    Node *partition_point(Predicate before) {
+        refresh();
+        tower *t = head;
+        for (int l = top; l >= 1; l--) {
+            while (t->links[l - 1].next != nullptr && before(t->links[l - 1].next->node)) {
+                t = t->links[l - 1].next;
+            }
+        }
+        Node *cur = t->node->next;
+        while (cur != sentinel && before(cur)) cur = cur->next;
+        return cur;
+    }
+};
+
+}
+
+}
+
+#endif //SJTU_SKIP_INDEX_HPP
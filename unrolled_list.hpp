@@ -0,0 +1,640 @@
+#ifndef SJTU_UNROLLED_LIST_HPP
+#define SJTU_UNROLLED_LIST_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+/*
+ * Doubly-linked list of chunks, each holding up to B elements inline, so a
+ * scan takes one pointer hop per chunk instead of one per element.
+ * Unlike list, an iterator addresses a (chunk, slot) pair: inserting or
+ * erasing in a chunk invalidates iterators into that chunk and into any
+ * neighbour it is split from or merged with. sort(), merge(), reverse()
+ * and unique() move elements rather than relinking them.
+ */
+template<typename T, size_t B = 16>
+class unrolled_list {
+    static_assert(B >= 2, "unrolled_list chunks must hold at least two elements");
+
+protected:
+    class chunk_base {
+    public:
+        chunk_base *prev;
+        chunk_base *next;
+        size_t size;
+
+        chunk_base() : prev(nullptr), next(nullptr), size(0) {}
+    };
+
+    class chunk : public chunk_base {
+    public:
+        alignas(T) unsigned char storage[sizeof(T) * B];
+
+        chunk() {}
+
+        ~chunk() {
+            T *d = data();
+            for (size_t i = 0; i < this->size; i++) {
+                d[i].~T();
+            }
+        }
+
+        T *data() {
+            return reinterpret_cast<T *>(storage);
+        }
+    };
+
+    // Chain of freshly filled chunks, used to rebuild the list in order.
+    class builder {
+    public:
+        chunk_base *first;
+        chunk_base *last;
+        size_t count;
+
+        builder() : first(nullptr), last(nullptr), count(0) {}
+
+        ~builder() {
+            while (first != nullptr) {
+                chunk_base *next = first->next;
+                delete static_cast<chunk *>(first);
+                first = next;
+            }
+        }
+
+        void append(T &&value) {
+            if (last == nullptr || last->size == B) {
+                chunk *c = new chunk();
+                c->prev = last;
+                if (last == nullptr) first = c;
+                else last->next = c;
+                last = c;
+            }
+            new (data_of(last) + last->size) T(std::move(value));
+            last->size++;
+            count++;
+        }
+
+        T &back() {
+            return data_of(last)[last->size - 1];
+        }
+    };
+
+    chunk_base *head;
+    chunk_base *tail;
+    size_t count;
+
+    static T *data_of(chunk_base *c) {
+        return static_cast<chunk *>(c)->data();
+    }
+
+    chunk_base *link_after(chunk_base *pos) {
+        chunk *c = new chunk();
+        c->prev = pos;
+        c->next = pos->next;
+        pos->next->prev = c;
+        pos->next = c;
+        return c;
+    }
+
+    void drop(chunk_base *c) {
+        c->prev->next = c->next;
+        c->next->prev = c->prev;
+        delete static_cast<chunk *>(c);
+    }
+
+    // Appends every element of c->next to c and frees c->next.
+    void absorb_next(chunk_base *c) {
+        chunk_base *n = c->next;
+        T *dst = data_of(c) + c->size;
+        T *src = data_of(n);
+        for (size_t i = 0; i < n->size; i++) {
+            new (dst + i) T(std::move(src[i]));
+        }
+        c->size += n->size;
+        drop(n);
+    }
+
+    // Replaces the current contents with the chain held by b.
+    void adopt(builder &b) {
+        clear();
+        if (b.first == nullptr) return;
+        b.first->prev = head;
+        b.last->next = tail;
+        head->next = b.first;
+        tail->prev = b.last;
+        count = b.count;
+        b.first = b.last = nullptr;
+        b.count = 0;
+    }
+
+public:
+    class const_iterator;
+    class iterator {
+    friend class unrolled_list;
+    friend class const_iterator;
+    private:
+        chunk_base *blk;
+        size_t idx;
+        const unrolled_list *container;
+
+    public:
+        iterator() : blk(nullptr), idx(0), container(nullptr) {}
+        iterator(chunk_base *b, size_t i, const unrolled_list *c) : blk(b), idx(i), container(c) {}
+
+        iterator operator++(int) {
+            iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        iterator & operator++() {
+            if (blk == nullptr || container == nullptr || blk == container->tail) {
+                throw invalid_iterator();
+            }
+            if (++idx == blk->size) {
+                blk = blk->next;
+                idx = 0;
+            }
+            return *this;
+        }
+
+        iterator operator--(int) {
+            iterator temp = *this;
+            --*this;
+            return temp;
+        }
+
+        iterator & operator--() {
+            if (blk == nullptr || container == nullptr || (blk == container->head->next && idx == 0)) {
+                throw invalid_iterator();
+            }
+            if (idx == 0) {
+                blk = blk->prev;
+                idx = blk->size;
+            }
+            idx--;
+            return *this;
+        }
+
+        T & operator *() const {
+            if (blk == nullptr || blk == container->head || blk == container->tail) {
+                throw invalid_iterator();
+            }
+            return data_of(blk)[idx];
+        }
+
+        T * operator ->() const {
+            return &**this;
+        }
+
+        bool operator==(const iterator &rhs) const {
+            return blk == rhs.blk && idx == rhs.idx;
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return blk == rhs.blk && idx == rhs.idx;
+        }
+
+        bool operator!=(const iterator &rhs) const {
+            return !(*this == rhs);
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
+    class const_iterator {
+    friend class unrolled_list;
+    friend class iterator;
+    private:
+        chunk_base *blk;
+        size_t idx;
+        const unrolled_list *container;
+
+    public:
+        const_iterator() : blk(nullptr), idx(0), container(nullptr) {}
+        const_iterator(chunk_base *b, size_t i, const unrolled_list *c) : blk(b), idx(i), container(c) {}
+        const_iterator(const iterator &it) : blk(it.blk), idx(it.idx), container(it.container) {}
+
+        const_iterator operator++(int) {
+            const_iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        const_iterator & operator++() {
+            if (blk == nullptr || container == nullptr || blk == container->tail) {
+                throw invalid_iterator();
+            }
+            if (++idx == blk->size) {
+                blk = blk->next;
+                idx = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator temp = *this;
+            --*this;
+            return temp;
+        }
+
+        const_iterator & operator--() {
+            if (blk == nullptr || container == nullptr || (blk == container->head->next && idx == 0)) {
+                throw invalid_iterator();
+            }
+            if (idx == 0) {
+                blk = blk->prev;
+                idx = blk->size;
+            }
+            idx--;
+            return *this;
+        }
+
+        const T & operator *() const {
+            if (blk == nullptr || blk == container->head || blk == container->tail) {
+                throw invalid_iterator();
+            }
+            return data_of(blk)[idx];
+        }
+
+        const T * operator ->() const {
+            return &**this;
+        }
+
+        bool operator==(const iterator &rhs) const {
+            return blk == rhs.blk && idx == rhs.idx;
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return blk == rhs.blk && idx == rhs.idx;
+        }
+
+        bool operator!=(const iterator &rhs) const {
+            return !(*this == rhs);
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
+    unrolled_list() {
+        head = new chunk_base();
+        tail = new chunk_base();
+        head->next = tail;
+        tail->prev = head;
+        count = 0;
+    }
+
+    unrolled_list(const unrolled_list &other) : unrolled_list() {
+        for (const_iterator it = other.cbegin(); it != other.cend(); ++it) {
+            push_back(*it);
+        }
+    }
+
+    unrolled_list(unrolled_list &&other) : unrolled_list() {
+        swap(other);
+    }
+
+    ~unrolled_list() {
+        clear();
+        delete head;
+        delete tail;
+    }
+
+    unrolled_list &operator=(const unrolled_list &other) {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        for (const_iterator it = other.cbegin(); it != other.cend(); ++it) {
+            push_back(*it);
+        }
+        return *this;
+    }
+
+    unrolled_list &operator=(unrolled_list &&other) {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        swap(other);
+        return *this;
+    }
+
+    void swap(unrolled_list &other) {
+        std::swap(head, other.head);
+        std::swap(tail, other.tail);
+        std::swap(count, other.count);
+    }
+
+    const T & front() const {
+        if (count == 0) {
+            throw container_is_empty();
+        }
+        return data_of(head->next)[0];
+    }
+
+    const T & back() const {
+        if (count == 0) {
+            throw container_is_empty();
+        }
+        return data_of(tail->prev)[tail->prev->size - 1];
+    }
+
+    iterator begin() {
+        return iterator(head->next, 0, this);
+    }
+
+    const_iterator cbegin() const {
+        return const_iterator(head->next, 0, this);
+    }
+
+    iterator end() {
+        return iterator(tail, 0, this);
+    }
+
+    const_iterator cend() const {
+        return const_iterator(tail, 0, this);
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    void clear() {
+        while (head->next != tail) {
+            drop(head->next);
+        }
+        count = 0;
+    }
+
+    template<typename... Args>
+    iterator emplace(iterator pos, Args &&... args) {
+        if (pos.container != this || pos.blk == head) {
+            throw invalid_iterator();
+        }
+        // args may refer into this list, and the split or shift below moves
+        // elements, so the value is built first.
+        T value(std::forward<Args>(args)...);
+        chunk_base *c = pos.blk;
+        size_t idx = pos.idx;
+        if (c == tail) {
+            c = tail->prev;
+            if (c == head || c->size == B) c = link_after(tail->prev);
+            idx = c->size;
+        } else if (idx == 0 && c->prev != head && c->prev->size < B) {
+            c = c->prev;
+            idx = c->size;
+        } else if (c->size == B) {
+            chunk_base *n = link_after(c);
+            size_t half = B / 2;
+            T *src = data_of(c);
+            T *dst = data_of(n);
+            for (size_t i = half; i < B; i++) {
+                new (dst + i - half) T(std::move(src[i]));
+                src[i].~T();
+            }
+            n->size = B - half;
+            c->size = half;
+            if (idx > half) {
+                c = n;
+                idx -= half;
+            }
+        }
+
+        T *d = data_of(c);
+        if (idx == c->size) {
+            try {
+                new (d + idx) T(std::move(value));
+            } catch (...) {
+                if (c->size == 0) drop(c);
+                throw;
+            }
+        } else {
+            new (d + c->size) T(std::move(d[c->size - 1]));
+            for (size_t i = c->size - 1; i > idx; i--) {
+                d[i] = std::move(d[i - 1]);
+            }
+            d[idx] = std::move(value);
+        }
+        c->size++;
+        count++;
+        return iterator(c, idx, this);
+    }
+
+    iterator insert(iterator pos, const T &value) {
+        return emplace(pos, value);
+    }
+
+    iterator insert(iterator pos, T &&value) {
+        return emplace(pos, std::move(value));
+    }
+
+    iterator erase(iterator pos) {
+        if (count == 0) {
+            throw container_is_empty();
+        }
+        if (pos.container != this || pos.blk == head || pos.blk == tail || pos.idx >= pos.blk->size) {
+            throw invalid_iterator();
+        }
+
+        chunk_base *c = pos.blk;
+        size_t idx = pos.idx;
+        T *d = data_of(c);
+        for (size_t i = idx; i + 1 < c->size; i++) {
+            d[i] = std::move(d[i + 1]);
+        }
+        d[c->size - 1].~T();
+        c->size--;
+        count--;
+
+        if (c->size == 0) {
+            chunk_base *n = c->next;
+            drop(c);
+            return iterator(n, 0, this);
+        }
+        // Keep chunks at least a quarter full by folding into a neighbour.
+        if (c->size <= B / 4) {
+            if (c->next != tail && c->size + c->next->size <= B) {
+                absorb_next(c);
+            } else if (c->prev != head && c->prev->size + c->size <= B) {
+                chunk_base *p = c->prev;
+                idx += p->size;
+                absorb_next(p);
+                c = p;
+            }
+        }
+        if (idx == c->size) {
+            return iterator(c->next, 0, this);
+        }
+        return iterator(c, idx, this);
+    }
+
+    void push_back(const T &value) {
+        emplace(end(), value);
+    }
+
+    void push_back(T &&value) {
+        emplace(end(), std::move(value));
+    }
+
+    template<typename... Args>
+    T &emplace_back(Args &&... args) {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
+
+    void pop_back() {
+        if (count == 0) {
+            throw container_is_empty();
+        }
+        erase(iterator(tail->prev, tail->prev->size - 1, this));
+    }
+
+    void push_front(const T &value) {
+        emplace(begin(), value);
+    }
+
+    void push_front(T &&value) {
+        emplace(begin(), std::move(value));
+    }
+
+    template<typename... Args>
+    T &emplace_front(Args &&... args) {
+        return *emplace(begin(), std::forward<Args>(args)...);
+    }
+
+    void pop_front() {
+        if (count == 0) {
+            throw container_is_empty();
+        }
+        erase(begin());
+    }
+
+    void sort() {
+        sort(std::less<>());
+    }
+
+    // Stable: orders element pointers, then moves the elements once into
+    // freshly packed chunks.
+    template<typename Compare>
+    void sort(Compare cmp) {
+        if (count <= 1) return;
+
+        // A throwing cmp leaves every element where it was.
+        std::unique_ptr<T *[]> arr(new T *[count]);
+        std::unique_ptr<T *[]> buf(new T *[count]);
+        size_t n = 0;
+        for (chunk_base *c = head->next; c != tail; c = c->next) {
+            T *d = data_of(c);
+            for (size_t i = 0; i < c->size; i++) {
+                arr[n++] = d + i;
+            }
+        }
+
+        T **src = arr.get(), **dst = buf.get();
+        for (size_t width = 1; width < n; width *= 2) {
+            for (size_t lo = 0; lo < n; lo += 2 * width) {
+                size_t mid = lo + width < n ? lo + width : n;
+                size_t hi = lo + 2 * width < n ? lo + 2 * width : n;
+                size_t i = lo, j = mid, k = lo;
+                while (i < mid && j < hi) {
+                    if (cmp(*src[j], *src[i])) dst[k++] = src[j++];
+                    else dst[k++] = src[i++];
+                }
+                while (i < mid) dst[k++] = src[i++];
+                while (j < hi) dst[k++] = src[j++];
+            }
+            T **tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+
+        builder b;
+        for (size_t i = 0; i < n; i++) {
+            b.append(std::move(*src[i]));
+        }
+        adopt(b);
+    }
+
+    void merge(unrolled_list &other) {
+        merge(other, std::less<>());
+    }
+
+    template<typename Compare>
+    void merge(unrolled_list &other, Compare cmp) {
+        if (this == &other || other.count == 0) return;
+
+        builder b;
+        iterator i = begin(), j = other.begin();
+        while (i.blk != tail && j.blk != other.tail) {
+            if (cmp(*j, *i)) {
+                b.append(std::move(*j));
+                ++j;
+            } else {
+                b.append(std::move(*i));
+                ++i;
+            }
+        }
+        for (; i.blk != tail; ++i) b.append(std::move(*i));
+        for (; j.blk != other.tail; ++j) b.append(std::move(*j));
+        other.clear();
+        adopt(b);
+    }
+
+    void reverse() {
+        if (count <= 1) return;
+
+        chunk_base *c = head->next;
+        while (c != tail) {
+            T *d = data_of(c);
+            for (size_t i = 0, j = c->size - 1; i < j; i++, j--) {
+                std::swap(d[i], d[j]);
+            }
+            chunk_base *temp = c->next;
+            c->next = c->prev;
+            c->prev = temp;
+            c = temp;
+        }
+
+        chunk_base *temp = head->next;
+        head->next = tail->prev;
+        tail->prev = temp;
+
+        head->next->prev = head;
+        tail->prev->next = tail;
+    }
+
+    void unique() {
+        unique(std::equal_to<>());
+    }
+
+    template<typename BinaryPredicate>
+    void unique(BinaryPredicate pred) {
+        if (count <= 1) return;
+
+        builder b;
+        for (iterator it = begin(); it.blk != tail; ++it) {
+            if (b.count == 0 || !pred(b.back(), *it)) {
+                b.append(std::move(*it));
+            }
+        }
+        adopt(b);
+    }
+};
+
+}
+
+#endif //SJTU_UNROLLED_LIST_HPP